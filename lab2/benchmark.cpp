@@ -0,0 +1,120 @@
+// Скорость умножения плотных матриц: блочный gemm (gemm.h) против
+// учебного тройного цикла i-j-k. Для каждого размера выводится лучшее время
+// из нескольких повторов и GFLOP/s (2 * m * n * k операций). Если потоков
+// больше одного, gemm измеряется и в одном потоке, и во всех потоках пула.
+// Транспонирование блоками (transpose.h) сравнивается по пропускной
+// способности (прочитанные и записанные байты в секунду) с memcpy.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark.out
+// Запуск: ./benchmark.out [потоки] [размер ...]
+//         (по умолчанию все аппаратные потоки и размеры 256 512 1024 2048)
+
+#include "matrix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void fillRandom(MatrixDense& matrix, std::mt19937_64& generator) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < matrix.rowCount(); ++i) {
+        for (int j = 0; j < matrix.colCount(); ++j) {
+            matrix(i, j) = dist(generator);
+        }
+    }
+}
+
+// Учебный тройной цикл i-j-k: второй множитель читается по столбцам
+static void multiplyNaive(const MatrixDense& a, const MatrixDense& b, MatrixDense& c) {
+    for (int i = 0; i < a.rowCount(); ++i) {
+        for (int j = 0; j < b.colCount(); ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < a.colCount(); ++k) {
+                sum += a(i, k) * b(k, j);
+            }
+            c(i, j) = sum;
+        }
+    }
+}
+
+template<typename Fn>
+static double bestOf(int repetitions, Fn&& fn) {
+    double best = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double seconds = secondsSince(start);
+        best = r == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t numThreads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 0;
+    parallel::setThreadCount(numThreads);
+    numThreads = parallel::threadCount();
+    std::vector<int> sizes;
+    for (int i = 2; i < argc; ++i) {
+        sizes.push_back(std::atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {256, 512, 1024, 2048};
+    }
+
+    std::cout << "микроядро: " << gemm::kernelName(gemm::detectKernel()) << ", потоков: " << numThreads << "\n";
+    std::mt19937_64 generator(42);
+    for (int n : sizes) {
+        MatrixDense a(n, n), b(n, n);
+        fillRandom(a, generator);
+        fillRandom(b, generator);
+        double flops = 2.0 * n * n * n;
+
+        MatrixDense* product = nullptr;
+        double blocked = bestOf(3, [&] {
+            delete product;
+            product = static_cast<MatrixDense*>(a.multiply(b));
+        });
+        std::cout << n << " x " << n << ": gemm " << blocked * 1000 << " мс (" << flops / blocked / 1e9 << " GFLOP/s)";
+
+        if (numThreads > 1) {
+            parallel::setThreadCount(1);
+            double single = bestOf(3, [&] { delete a.multiply(b); });
+            parallel::setThreadCount(numThreads);
+            std::cout << ", в одном потоке " << single * 1000 << " мс (ускорение " << single / blocked << ")";
+        }
+
+        // Тройной цикл слишком медленный для больших матриц
+        if (n <= 1024) {
+            MatrixDense naive(n, n);
+            double seconds = bestOf(1, [&] { multiplyNaive(a, b, naive); });
+            double maxError = 0;
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    maxError = std::max(maxError, std::abs(naive(i, j) - (*product)(i, j)));
+                }
+            }
+            std::cout << ", i-j-k " << seconds * 1000 << " мс (" << flops / seconds / 1e9
+                      << " GFLOP/s), расхождение " << maxError;
+        }
+        std::cout << "\n";
+        delete product;
+
+        // В заранее выделенную матрицу, чтобы не измерять первое обращение к страницам
+        MatrixDense transposed(n, n);
+        size_t ld = a.leadingDimension();
+        double bytes = 2.0 * n * ld * sizeof(double);
+        double tiled = bestOf(3, [&] { transposition::copy(n, n, a.data(), ld, transposed.data(), ld); });
+        double copied = bestOf(3, [&] { std::memcpy(transposed.data(), a.data(), n * ld * sizeof(double)); });
+        std::cout << "    транспонирование " << bytes / tiled / 1e9 << " ГБ/с, memcpy " << bytes / copied / 1e9
+                  << " ГБ/с\n";
+    }
+    return 0;
+}
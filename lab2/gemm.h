@@ -0,0 +1,390 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "threadPool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATRIX_GEMM_X86 1
+#else
+#define MATRIX_GEMM_X86 0
+#endif
+
+// Умножение плотных матриц по схеме GotoBLAS: C += A * B.
+//
+// Три внешних цикла режут задачу на блоки под уровни кэша:
+//   - по столбцам C шагом nc: панель B размером kc x nc упаковывается и живет в L3;
+//   - по общему измерению шагом kc;
+//   - по строкам C шагом mc: блок A размером mc x kc упаковывается и живет в L2.
+// Внутри блока микроядро считает плитку C размером MR x NR в регистрах: на
+// каждом шаге k оно читает NR подряд идущих элементов упакованной B (из L1)
+// и MR элементов упакованной A и делает MR * NR / ширину_вектора FMA.
+// Упаковка переписывает блоки в порядок чтения микроядром, поэтому оно идет
+// по памяти строго подряд, а шаги исходных матриц влияют только на упаковку.
+// Микроядро (AVX-512, AVX2+FMA или скалярное) выбирается один раз во время
+// выполнения по возможностям процессора.
+namespace gemm {
+
+// Матрица только для чтения с произвольными шагами: элемент (i, j) лежит в
+// data[i * rowStride + j * colStride]. Строчная матрица - {data, ld, 1},
+// транспонированная без копирования - {data, 1, ld}.
+struct MatrixRef {
+    const double* data;
+    size_t rowStride;
+    size_t colStride;
+
+    double operator()(size_t i, size_t j) const { return data[i * rowStride + j * colStride]; }
+
+    // Подматрица, начинающаяся в (i, j)
+    MatrixRef at(size_t i, size_t j) const { return {data + i * rowStride + j * colStride, rowStride, colStride}; }
+};
+
+// Высота плитки микроядра у всех вариантов
+constexpr size_t MR = 6;
+// Блоки: kc * NR * 8 байт упакованной B на микропанель - в L1, mc x kc блок A
+// (~240 КБ) - в L2, kc x nc панель B (до 8 МБ) - в L3
+constexpr size_t KC = 256;
+constexpr size_t MC = 120;
+constexpr size_t NC = 4096;
+
+enum class Kernel { Scalar, AVX2, AVX512 };
+
+inline Kernel detectKernel() {
+    static const Kernel kernel = [] {
+#if MATRIX_GEMM_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return Kernel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return Kernel::AVX2;
+        }
+#endif
+        return Kernel::Scalar;
+    }();
+    return kernel;
+}
+
+inline const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::AVX512: return "AVX-512";
+        case Kernel::AVX2: return "AVX2+FMA";
+        default: return "scalar";
+    }
+}
+
+// Ширина плитки микроядра: два вектора
+inline size_t kernelWidth(Kernel kernel) {
+    return kernel == Kernel::AVX512 ? 16 : 8;
+}
+
+namespace detail {
+
+// Скалярное микроядро 6 x 8 для процессоров без AVX2
+inline void kernelScalar(size_t kc, const double* a, const double* b, double* c, size_t ldc) {
+    double acc[MR][8] = {};
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t i = 0; i < MR; ++i) {
+            for (size_t j = 0; j < 8; ++j) {
+                acc[i][j] += a[i] * b[j];
+            }
+        }
+        a += MR;
+        b += 8;
+    }
+    for (size_t i = 0; i < MR; ++i) {
+        for (size_t j = 0; j < 8; ++j) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+#if MATRIX_GEMM_X86
+
+// 6 x 8: двенадцать аккумуляторов по 4 double, на шаг k - две загрузки B,
+// шесть рассылок A и двенадцать FMA
+__attribute__((target("avx2,fma")))
+inline void kernelAvx2(size_t kc, const double* a, const double* b, double* c, size_t ldc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+    for (size_t p = 0; p < kc; ++p) {
+        __m256d b0 = _mm256_load_pd(b);
+        __m256d b1 = _mm256_load_pd(b + 4);
+        __m256d ai = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(ai, b0, c00);
+        c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10);
+        c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20);
+        c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30);
+        c31 = _mm256_fmadd_pd(ai, b1, c31);
+        ai = _mm256_broadcast_sd(a + 4);
+        c40 = _mm256_fmadd_pd(ai, b0, c40);
+        c41 = _mm256_fmadd_pd(ai, b1, c41);
+        ai = _mm256_broadcast_sd(a + 5);
+        c50 = _mm256_fmadd_pd(ai, b0, c50);
+        c51 = _mm256_fmadd_pd(ai, b1, c51);
+        a += MR;
+        b += 8;
+    }
+    __m256d rows[MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t i = 0; i < MR; ++i) {
+        double* row = c + i * ldc;
+        _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), rows[i][0]));
+        _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), rows[i][1]));
+    }
+}
+
+// 6 x 16: то же на векторах по 8 double
+__attribute__((target("avx512f")))
+inline void kernelAvx512(size_t kc, const double* a, const double* b, double* c, size_t ldc) {
+    __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+    __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+    __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+    __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+    __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+    __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+    for (size_t p = 0; p < kc; ++p) {
+        __m512d b0 = _mm512_load_pd(b);
+        __m512d b1 = _mm512_load_pd(b + 8);
+        __m512d ai = _mm512_set1_pd(a[0]);
+        c00 = _mm512_fmadd_pd(ai, b0, c00);
+        c01 = _mm512_fmadd_pd(ai, b1, c01);
+        ai = _mm512_set1_pd(a[1]);
+        c10 = _mm512_fmadd_pd(ai, b0, c10);
+        c11 = _mm512_fmadd_pd(ai, b1, c11);
+        ai = _mm512_set1_pd(a[2]);
+        c20 = _mm512_fmadd_pd(ai, b0, c20);
+        c21 = _mm512_fmadd_pd(ai, b1, c21);
+        ai = _mm512_set1_pd(a[3]);
+        c30 = _mm512_fmadd_pd(ai, b0, c30);
+        c31 = _mm512_fmadd_pd(ai, b1, c31);
+        ai = _mm512_set1_pd(a[4]);
+        c40 = _mm512_fmadd_pd(ai, b0, c40);
+        c41 = _mm512_fmadd_pd(ai, b1, c41);
+        ai = _mm512_set1_pd(a[5]);
+        c50 = _mm512_fmadd_pd(ai, b0, c50);
+        c51 = _mm512_fmadd_pd(ai, b1, c51);
+        a += MR;
+        b += 16;
+    }
+    __m512d rows[MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t i = 0; i < MR; ++i) {
+        double* row = c + i * ldc;
+        _mm512_storeu_pd(row, _mm512_add_pd(_mm512_loadu_pd(row), rows[i][0]));
+        _mm512_storeu_pd(row + 8, _mm512_add_pd(_mm512_loadu_pd(row + 8), rows[i][1]));
+    }
+}
+
+#endif
+
+inline void runKernel(Kernel kernel, size_t kc, const double* a, const double* b, double* c, size_t ldc) {
+#if MATRIX_GEMM_X86
+    if (kernel == Kernel::AVX512) {
+        kernelAvx512(kc, a, b, c, ldc);
+        return;
+    }
+    if (kernel == Kernel::AVX2) {
+        kernelAvx2(kc, a, b, c, ldc);
+        return;
+    }
+#endif
+    kernelScalar(kc, a, b, c, ldc);
+}
+
+// Выровненный буфер упаковки, который растет по необходимости. У каждого
+// потока свой, поэтому вызовы из разных потоков не мешают друг другу.
+class PackBuffer {
+private:
+    struct FreeDeleter {
+        void operator()(double* ptr) const { std::free(ptr); }
+    };
+
+    std::unique_ptr<double[], FreeDeleter> buffer;
+    size_t capacity = 0;
+
+public:
+    double* get(size_t count) {
+        if (count > capacity) {
+            size_t bytes = (count * sizeof(double) + 63) / 64 * 64;
+            void* memory = std::aligned_alloc(64, bytes);
+            if (!memory) {
+                throw std::bad_alloc();
+            }
+            buffer.reset(static_cast<double*>(memory));
+            capacity = bytes / sizeof(double);
+        }
+        return buffer.get();
+    }
+};
+
+// Упаковка блока A (mc x kc) в микропанели по MR строк: в панели элементы
+// идут по k, для каждого k - MR значений подряд. Неполная панель
+// дополняется нулями.
+inline void packA(MatrixRef a, size_t mc, size_t kc, double* packed) {
+    for (size_t i0 = 0; i0 < mc; i0 += MR) {
+        size_t rowsInPanel = std::min(MR, mc - i0);
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t i = 0; i < rowsInPanel; ++i) {
+                packed[i] = a(i0 + i, p);
+            }
+            for (size_t i = rowsInPanel; i < MR; ++i) {
+                packed[i] = 0.0;
+            }
+            packed += MR;
+        }
+    }
+}
+
+// Упаковка панели B (kc x nc) в микропанели по nr столбцов: для каждого k -
+// nr значений строки подряд. Неполная панель дополняется нулями.
+inline void packB(MatrixRef b, size_t kc, size_t nc, size_t nr, double* packed) {
+    for (size_t j0 = 0; j0 < nc; j0 += nr) {
+        size_t colsInPanel = std::min(nr, nc - j0);
+        for (size_t p = 0; p < kc; ++p) {
+            if (b.colStride == 1) {
+                std::memcpy(packed, b.data + p * b.rowStride + j0, colsInPanel * sizeof(double));
+            } else {
+                for (size_t j = 0; j < colsInPanel; ++j) {
+                    packed[j] = b(p, j0 + j);
+                }
+            }
+            for (size_t j = colsInPanel; j < nr; ++j) {
+                packed[j] = 0.0;
+            }
+            packed += nr;
+        }
+    }
+}
+
+// Макроядро: упакованный блок A (mc x kc) на nc столбцов упакованной
+// панели B, начиная с ее первой микропанели. c - элемент C, соответствующий
+// началу обоих.
+inline void macroKernel(Kernel kernel, size_t mc, size_t nc, size_t kc, const double* blockA, const double* panelB,
+                        double* c, size_t ldc) {
+    size_t nr = kernelWidth(kernel);
+    // Плитка для краев: микроядро всегда считает MR x nr
+    alignas(64) double edge[MR * 16];
+    for (size_t jr = 0; jr < nc; jr += nr) {
+        size_t cols = std::min(nr, nc - jr);
+        const double* microB = panelB + jr * kc;
+        for (size_t ir = 0; ir < mc; ir += MR) {
+            size_t rows = std::min(MR, mc - ir);
+            const double* microA = blockA + ir * kc;
+            double* tile = c + ir * ldc + jr;
+            if (rows == MR && cols == nr) {
+                runKernel(kernel, kc, microA, microB, tile, ldc);
+                continue;
+            }
+            std::fill(edge, edge + MR * nr, 0.0);
+            runKernel(kernel, kc, microA, microB, edge, nr);
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    tile[i * ldc + j] += edge[i * nr + j];
+                }
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+// C[0, m) x [0, n) += A (m x k) * B (k x n). C - строчная матрица с ведущей
+// размерностью ldc.
+inline void multiply(size_t m, size_t n, size_t k, MatrixRef a, MatrixRef b, double* c, size_t ldc) {
+    if (m == 0 || n == 0 || k == 0) {
+        return;
+    }
+    Kernel kernel = detectKernel();
+    size_t nr = kernelWidth(kernel);
+
+    thread_local detail::PackBuffer packedA, packedB;
+    double* blockA = packedA.get((MC + MR) * KC);
+    double* panelB = packedB.get((std::min(NC, n) + nr) * KC);
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = std::min(NC, n - jc);
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = std::min(KC, k - pc);
+            detail::packB(b.at(pc, jc), kc, nc, nr, panelB);
+            for (size_t ic = 0; ic < m; ic += MC) {
+                size_t mc = std::min(MC, m - ic);
+                detail::packA(a.at(ic, pc), mc, kc, blockA);
+                detail::macroKernel(kernel, mc, nc, kc, blockA, panelB, c + ic * ldc + jc, ldc);
+            }
+        }
+    }
+}
+
+// То же в общем пуле потоков (threadPool.h). Панель B упаковывается один раз
+// всеми потоками и общая для них, а C делится на плитки: по строкам блоками
+// MC, и, если таких блоков меньше, чем нужно для загрузки потоков, еще и по
+// столбцам группами микропанелей. Каждый поток упаковывает блок A своей
+// плитки. Плитки не пересекаются, а шаги по k идут по очереди, поэтому
+// записи в C не конфликтуют. Небольшие произведения считаются в одном потоке.
+inline void multiplyParallel(size_t m, size_t n, size_t k, MatrixRef a, MatrixRef b, double* c, size_t ldc) {
+    constexpr size_t minParallelWork = size_t(1) << 21; // m * n * k
+    constexpr size_t tilesPerThread = 2;
+    if (m == 0 || n == 0 || k == 0) {
+        return;
+    }
+    parallel::ThreadPool& pool = parallel::pool();
+    size_t numThreads = pool.size();
+    if (numThreads == 1 || m * n * k < minParallelWork) {
+        multiply(m, n, k, a, b, c, ldc);
+        return;
+    }
+    Kernel kernel = detectKernel();
+    size_t nr = kernelWidth(kernel);
+
+    // Панель B общая: буфер вызывающего потока, пока он ждет в run()
+    thread_local detail::PackBuffer packedB;
+    double* panelB = packedB.get((std::min(NC, n) + nr) * KC);
+
+    size_t rowBlocks = (m + MC - 1) / MC;
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = std::min(NC, n - jc);
+        size_t panels = (nc + nr - 1) / nr;
+        size_t wantedGroups = (numThreads * tilesPerThread + rowBlocks - 1) / rowBlocks;
+        size_t colGroups = std::min(panels, wantedGroups);
+        size_t groupPanels = (panels + colGroups - 1) / colGroups;
+        colGroups = (panels + groupPanels - 1) / groupPanels;
+        size_t packPanels = (panels + numThreads - 1) / numThreads;
+        size_t packTasks = (panels + packPanels - 1) / packPanels;
+
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = std::min(KC, k - pc);
+            pool.run(packTasks, [&](size_t task) {
+                size_t j0 = task * packPanels * nr;
+                size_t cols = std::min(packPanels * nr, nc - j0);
+                detail::packB(b.at(pc, jc + j0), kc, cols, nr, panelB + j0 * kc);
+            });
+            pool.run(rowBlocks * colGroups, [&](size_t task) {
+                size_t ic = task / colGroups * MC;
+                size_t j0 = task % colGroups * groupPanels * nr;
+                size_t mc = std::min(MC, m - ic);
+                size_t cols = std::min(groupPanels * nr, nc - j0);
+                thread_local detail::PackBuffer packedA;
+                double* blockA = packedA.get((MC + MR) * KC);
+                detail::packA(a.at(ic, pc), mc, kc, blockA);
+                detail::macroKernel(kernel, mc, cols, kc, blockA, panelB + j0 * kc, c + ic * ldc + jc + j0, ldc);
+            });
+        }
+    }
+}
+
+} // namespace gemm
@@ -3,10 +3,25 @@
 #include <stdexcept>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
 
+#include "gemm.h"
+#include "threadPool.h"
+#include "transpose.h"
+
+class MatrixDense;
+class MatrixDiagonal;
 
 class Matrix {
 public:
+    // Операции над двумя матрицами, которые выбирают ядро по паре типов
+    enum class Operation { Add, Subtract, ElementwiseMultiply, Multiply };
+
     virtual ~Matrix() = default; // Деструктор
 
     virtual Matrix* add(const Matrix& other) const = 0; // Сложение
@@ -18,15 +33,143 @@ public:
     virtual void Import(const std::string& filename) = 0; // Импорт матрицы из файла
     virtual void Export(const std::string& filename) const = 0; // Экспорт матрицы в файл
     virtual void Print() const = 0; // Вывод матрицы на экран
+
+    // Двойная диспетчеризация: a.add(b) вызывает b.applyTo(Operation::Add, a),
+    // и правый операнд, зная теперь оба типа, выбирает ядро для пары (left, this)
+    virtual Matrix* applyTo(Operation op, const MatrixDense& left) const = 0;
+    virtual Matrix* applyTo(Operation op, const MatrixDiagonal& left) const = 0;
+};
+
+// Невладеющий вид на size элементов data[0], data[stride], ... - строка
+// (stride = 1) или столбец (stride = ld) плотной матрицы
+template<typename T>
+class MatrixSpan {
+private:
+    T* ptr;
+    int length;
+    int step;
+
+public:
+    MatrixSpan(T* data, int size, int stride) : ptr(data), length(size), step(stride) {}
+
+    int size() const { return length; }
+    int stride() const { return step; }
+    T* data() const { return ptr; }
+
+    T& operator[](int i) const { return ptr[static_cast<size_t>(i) * step]; }
 };
 
 class MatrixDense : public Matrix {
 private:
-    std::vector<std::vector<double>> data;
+    // Освобождение буфера, выделенного std::aligned_alloc
+    struct FreeDeleter {
+        void operator()(double* ptr) const { std::free(ptr); }
+    };
+
+    // Начало каждой строки выровнено по строке кэша (8 double)
+    static constexpr size_t alignment = 64;
+    static constexpr int rowAlignment = alignment / sizeof(double);
+
     int rows, cols;
+    int ld; // ведущая размерность: расстояние между началами строк в элементах
+    std::unique_ptr<double[], FreeDeleter> buffer;
+
+    // Размеры проверяются здесь и в allocate, до выделения буфера в списке
+    // инициализации конструктора
+    static int leadingDimension(int cols) {
+        if (cols < 0) {
+            throw std::invalid_argument("Размеры матрицы не могут быть отрицательными");
+        }
+        return (cols + rowAlignment - 1) / rowAlignment * rowAlignment;
+    }
+
+    // Буфер rows * ld элементов одним выделением памяти; обнуляется, если
+    // zero (иначе его целиком заполняет вызывающий, включая хвосты строк)
+    static std::unique_ptr<double[], FreeDeleter> allocate(int rows, int ld, bool zero = true) {
+        if (rows < 0) {
+            throw std::invalid_argument("Размеры матрицы не могут быть отрицательными");
+        }
+        size_t count = static_cast<size_t>(rows) * ld;
+        if (count == 0) {
+            return nullptr;
+        }
+        void* memory = std::aligned_alloc(alignment, count * sizeof(double));
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        if (zero) {
+            std::memset(memory, 0, count * sizeof(double));
+        }
+        return std::unique_ptr<double[], FreeDeleter>(static_cast<double*>(memory));
+    }
+
+    struct Uninitialized {};
+
+    // Матрица с необнуленными элементами для результатов, которые
+    // записываются целиком
+    MatrixDense(int rows, int cols, Uninitialized)
+        : rows(rows), cols(cols), ld(leadingDimension(cols)), buffer(allocate(rows, ld, false)) {}
+
+    // Применяет op к соответствующим элементам двух матриц одного размера;
+    // блоки строк обрабатываются в общем пуле потоков
+    template<typename Op>
+    MatrixDense* elementwise(const MatrixDense& other, Op op) const {
+        MatrixDense* result = new MatrixDense(rows, cols, Uninitialized());
+        parallel::forEachRowBlock(rows, cols, [&](size_t begin, size_t end) {
+            for (int i = static_cast<int>(begin); i < static_cast<int>(end); ++i) {
+                const double* left = rowData(i);
+                const double* right = other.rowData(i);
+                double* out = result->rowData(i);
+                for (int j = 0; j < cols; ++j) {
+                    out[j] = op(left[j], right[j]);
+                }
+                std::fill(out + cols, out + ld, 0.0);
+            }
+        });
+        return result;
+    }
 
 public:
-    MatrixDense(int rows, int cols) : rows(rows), cols(cols), data(rows, std::vector<double>(cols)) {}
+    MatrixDense(int rows, int cols) : rows(rows), cols(cols), ld(leadingDimension(cols)), buffer(allocate(rows, ld)) {}
+
+    MatrixDense(const MatrixDense& other)
+        : rows(other.rows), cols(other.cols), ld(other.ld), buffer(allocate(rows, ld, false)) {
+        if (buffer) {
+            std::memcpy(buffer.get(), other.buffer.get(), static_cast<size_t>(rows) * ld * sizeof(double));
+        }
+    }
+
+    MatrixDense(MatrixDense&& other) noexcept
+        : rows(std::exchange(other.rows, 0)), cols(std::exchange(other.cols, 0)), ld(std::exchange(other.ld, 0)),
+          buffer(std::move(other.buffer)) {}
+
+    MatrixDense& operator=(MatrixDense other) noexcept {
+        std::swap(rows, other.rows);
+        std::swap(cols, other.cols);
+        std::swap(ld, other.ld);
+        std::swap(buffer, other.buffer);
+        return *this;
+    }
+
+    int rowCount() const { return rows; }
+    int colCount() const { return cols; }
+    int leadingDimension() const { return ld; }
+
+    // Элемент (i, j) хранится в data()[i * leadingDimension() + j]
+    double* data() { return buffer.get(); }
+    const double* data() const { return buffer.get(); }
+
+    double* rowData(int i) { return buffer.get() + static_cast<size_t>(i) * ld; }
+    const double* rowData(int i) const { return buffer.get() + static_cast<size_t>(i) * ld; }
+
+    // Доступ без проверки индексов; проверяет set
+    double& operator()(int i, int j) { return rowData(i)[j]; }
+    double operator()(int i, int j) const { return rowData(i)[j]; }
+
+    MatrixSpan<double> row(int i) { return MatrixSpan<double>(rowData(i), cols, 1); }
+    MatrixSpan<const double> row(int i) const { return MatrixSpan<const double>(rowData(i), cols, 1); }
+    MatrixSpan<double> col(int j) { return MatrixSpan<double>(buffer.get() + j, rows, ld); }
+    MatrixSpan<const double> col(int j) const { return MatrixSpan<const double>(buffer.get() + j, rows, ld); }
 
     // Проверка эквивалентности размеров матриц
     void checkSize(const MatrixDense* other) const {
@@ -35,133 +178,194 @@ public:
         }
     }
 
+    // Тип второго операнда выбирает ядро (см. applyTo)
     Matrix* add(const Matrix& other) const override {
-        // Приводим матрицу к типу MatrixDense
-        const MatrixDense* otherDense = dynamic_cast<const MatrixDense*>(&other);
-        checkSize(otherDense);
-
-        // Создаем результирующую матрицу
-        MatrixDense* result = new MatrixDense(rows, cols);
-        
-        // Поэлементное сложение
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result->data[i][j] = data[i][j] + otherDense->data[i][j];
-            }
-        }
-
-        return result;
+        return other.applyTo(Operation::Add, *this);
     }
-    
+
     Matrix* subtract(const Matrix& other) const override {
-        const MatrixDense* otherDense = dynamic_cast<const MatrixDense*>(&other);
-        checkSize(otherDense);
+        return other.applyTo(Operation::Subtract, *this);
+    }
 
-        MatrixDense* result = new MatrixDense(rows, cols);
-        
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result->data[i][j] = data[i][j] - otherDense->data[i][j];
-            }
+    Matrix* elementwiseMultiply(const Matrix& other) const override {
+        return other.applyTo(Operation::ElementwiseMultiply, *this);
+    }
+
+    // Невладеющий вид на матрицу, возможно транспонированную: флаг только
+    // меняет местами шаги по строкам и столбцам, элементы не копируются.
+    // Действителен, пока жива матрица.
+    class View {
+    private:
+        const MatrixDense* matrix;
+        bool flag;
+
+    public:
+        explicit View(const MatrixDense& matrix, bool transposed = false) : matrix(&matrix), flag(transposed) {}
+
+        bool transposed() const { return flag; }
+        int rowCount() const { return flag ? matrix->cols : matrix->rows; }
+        int colCount() const { return flag ? matrix->rows : matrix->cols; }
+
+        double operator()(int i, int j) const { return flag ? (*matrix)(j, i) : (*matrix)(i, j); }
+
+        // Тот же вид с противоположным флагом
+        View t() const { return View(*matrix, !flag); }
+
+        // Ссылка на элементы для gemm: транспонирование учитывается при упаковке
+        gemm::MatrixRef ref() const {
+            size_t ld = static_cast<size_t>(matrix->ld);
+            return flag ? gemm::MatrixRef{matrix->data(), 1, ld} : gemm::MatrixRef{matrix->data(), ld, 1};
         }
+    };
 
-        return result;
+    View view() const { return View(*this); }
+    View transposedView() const { return View(*this, true); }
+
+    // Проверка согласованности размеров для произведения (m x k) * (k x n)
+    static void checkMultiplySize(int leftCols, int rightRows) {
+        if (leftCols != rightRows) {
+            throw std::invalid_argument("Число столбцов первой матрицы (" + std::to_string(leftCols) +
+                                        ") не равно числу строк второй (" + std::to_string(rightRows) + ").");
+        }
     }
 
-    Matrix* elementwiseMultiply(const Matrix& other) const override {
-        const MatrixDense* otherDense = dynamic_cast<const MatrixDense*>(&other);
-        checkSize(otherDense);
+    // Произведение видов, например a.transposedView() * b, без
+    // материализации транспонированных матриц
+    static MatrixDense* multiply(View left, View right) {
+        checkMultiplySize(left.colCount(), right.rowCount());
 
-        MatrixDense* result = new MatrixDense(rows, cols);
-        
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result->data[i][j] = data[i][j] * otherDense->data[i][j];
-            }
-        }
+        // gemm прибавляет произведение к обнуленному результату (см. gemm.h).
+        // Обнуляют его те же потоки, что потом пишут в эти строки.
+        MatrixDense* result = new MatrixDense(left.rowCount(), right.colCount(), Uninitialized());
+        parallel::forEachRowBlock(result->rows, result->ld, [&](size_t begin, size_t end) {
+            std::fill(result->rowData(static_cast<int>(begin)), result->rowData(static_cast<int>(end)), 0.0);
+        });
+        gemm::multiplyParallel(result->rows, result->cols, left.colCount(), left.ref(), right.ref(), result->data(),
+                               result->ld);
 
         return result;
     }
 
     Matrix* multiply(const Matrix& other) const override {
-        const MatrixDense* otherDense = dynamic_cast<const MatrixDense*>(&other);
-        checkSize(otherDense);
+        return other.applyTo(Operation::Multiply, *this);
+    }
 
-        MatrixDense* result = new MatrixDense(rows, otherDense->cols);
-        
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < otherDense->cols; ++j) {
-                double sum = 0.0;
-                for (int k = 0; k < cols; ++k) {
-                    sum += data[i][k] * otherDense->data[k][j];
-                }
-                result->data[i][j] = sum;
-            }
+    // left op this для двух плотных матриц
+    Matrix* applyTo(Operation op, const MatrixDense& left) const override {
+        if (op == Operation::Multiply) {
+            return multiply(left.view(), view());
+        }
+        left.checkSize(this);
+        switch (op) {
+            case Operation::Add:
+                // Поэлементное сложение по строкам: каждая строка - непрерывный участок
+                return left.elementwise(*this, [](double a, double b) { return a + b; });
+            case Operation::Subtract:
+                return left.elementwise(*this, [](double a, double b) { return a - b; });
+            default:
+                return left.elementwise(*this, [](double a, double b) { return a * b; });
         }
-
-        return result;
     }
 
+    // left op this, left - диагональная (определено после MatrixDiagonal)
+    Matrix* applyTo(Operation op, const MatrixDiagonal& left) const override;
+
+    // Ядра для пар с диагональной матрицей D той же размерности: O(n^2)
+    // вместо разворачивания D в плотную матрицу и O(n^3) умножения.
+    // this * D: столбец j умножается на D[j]
+    MatrixDense* scaleColumns(const MatrixDiagonal& diagonal) const;
+    // D * this: строка i умножается на D[i]
+    MatrixDense* scaleRows(const MatrixDiagonal& diagonal) const;
+    // selfSign * this + diagonalSign * D: копия, у которой меняется только диагональ
+    MatrixDense* addDiagonal(const MatrixDiagonal& diagonal, double selfSign, double diagonalSign) const;
+    // Поэлементное произведение с D ненулевое только на диагонали
+    MatrixDiagonal* multiplyDiagonal(const MatrixDiagonal& diagonal) const;
+
     Matrix* transpose() const override {
         // Создаем новую матрицу с перевернутыми размерами.
-        MatrixDense* result = new MatrixDense(cols, rows);
-        
-        // Транспонирование: меняем местами индексы строк и столбцов.
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result->data[j][i] = data[i][j];
+        MatrixDense* result = new MatrixDense(cols, rows, Uninitialized());
+
+        // Строки [begin, end) результата - столбцы исходной матрицы; они
+        // переписываются блоками с транспонированием плиток в регистрах
+        // (transpose.h) в общем пуле потоков.
+        parallel::forEachRowBlock(cols, rows, [&](size_t begin, size_t end) {
+            transposition::copy(rows, end - begin, data() + begin, ld, result->rowData(static_cast<int>(begin)),
+                                result->ld);
+            for (size_t j = begin; j < end; ++j) {
+                double* out = result->rowData(static_cast<int>(j));
+                std::fill(out + rows, out + result->ld, 0.0);
             }
-        }
+        });
 
         // Возвращаем указатель на транспонированную матрицу.
         return result;
     }
 
+    // Транспонирование без выделения памяти для квадратной матрицы; у
+    // прямоугольной меняется форма, поэтому она переписывается через копию
+    void transposeInPlace() {
+        if (rows != cols) {
+            std::unique_ptr<Matrix> transposed(transpose());
+            *this = std::move(static_cast<MatrixDense&>(*transposed));
+            return;
+        }
+        size_t n = static_cast<size_t>(rows);
+        parallel::forEachRowBlock(transposition::blockCount(n), n * transposition::blockSize,
+                                  [&](size_t begin, size_t end) {
+                                      transposition::inPlace(n, data(), ld, begin, end);
+                                  });
+    }
+
     void set(int row, int col, double value) {
         if (row < 0 || row >= rows || col < 0 || col >= cols) {
             throw std::out_of_range("Индекс вне диапазона");
         }
-        data[row][col] = value;
+        (*this)(row, col) = value;
     }
 
     void Import(const std::string& filename) override {
-        std::ifstream file(filename); 
+        std::ifstream file(filename);
         if (!file.is_open()) {
-            throw std::runtime_error("Не удается открыть файл."); 
+            throw std::runtime_error("Не удается открыть файл.");
         }
 
-        std::string className; 
+        std::string className;
         file >> className;
         if (className != "MatrixDense") {
             throw std::runtime_error("Недопустимый тип матрицы.");
         }
 
-        file >> rows >> cols;
-        data.resize(rows, std::vector<double>(cols)); 
+        int newRows = 0, newCols = 0;
+        if (!(file >> newRows >> newCols) || newRows < 0 || newCols < 0) {
+            throw std::runtime_error("Ошибка при считывании размеров матрицы.");
+        }
 
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                if (!(file >> data[i][j])) { 
+        // Читаем в новую матрицу нужного размера и заменяем текущую только
+        // после успешного чтения всех элементов
+        MatrixDense loaded(newRows, newCols);
+        for (int i = 0; i < newRows; ++i) {
+            for (int j = 0; j < newCols; ++j) {
+                if (!(file >> loaded(i, j))) {
                     throw std::runtime_error("Ошибка при считывании данных матрицы.");
                 }
             }
         }
 
-        file.close();
+        *this = std::move(loaded);
     }
 
     void Export(const std::string& filename) const override {
         std::ofstream file(filename);
         if (!file.is_open()) {
-            throw std::runtime_error("Не удается открыть файл.."); 
+            throw std::runtime_error("Не удается открыть файл..");
         }
 
         file << "MatrixDense\n";
-        file << rows << " " << cols << "\n"; 
+        file << rows << " " << cols << "\n";
 
-        for (const auto& row : data) {
-            for (double value : row) {
-                file << value << " "; 
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                file << (*this)(i, j) << " ";
             }
             file << "\n";
         }
@@ -170,9 +374,9 @@ public:
     }
 
     void Print() const override{
-        for (const auto& row : data) {
-            for (double value : row) {
-                std::cout << value << " "; 
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                std::cout << (*this)(i, j) << " ";
             }
             std::cout << "\n";
         }
@@ -189,6 +393,10 @@ private:
 public:
     MatrixDiagonal(int size) : size(size), data(size) {}
 
+    int rowCount() const { return size; }
+    int colCount() const { return size; }
+    const std::vector<double>& diagonal() const { return data; }
+
     // Проверка эквивалентности размеров матриц
     void checkSize(const MatrixDiagonal* other) const {
         if (!other || size != other->size) {
@@ -196,59 +404,53 @@ public:
         }
     }
 
+    // Тип второго операнда выбирает ядро (см. applyTo)
     Matrix* add(const Matrix& other) const override {
-        // Приводим матрицу к типу MatrixDense
-        const MatrixDiagonal* otherDiag = dynamic_cast<const MatrixDiagonal*>(&other);
-        checkSize(otherDiag);
-        
-        //Создание новой диагональной матрицы для хранения результата.
-        MatrixDiagonal* result = new MatrixDiagonal(size);
-
-        //Сложение соответствующих элементов диагоналей двух матриц.
-        for (int i = 0; i < size; ++i) {
-            result->data[i] = data[i] + otherDiag->data[i];
-        }
-    
-        return result;
+        return other.applyTo(Operation::Add, *this);
     }
 
     Matrix* subtract(const Matrix& other) const override {
-        const MatrixDiagonal* otherDiag = dynamic_cast<const MatrixDiagonal*>(&other);
-        checkSize(otherDiag);
-        
-        MatrixDiagonal* result = new MatrixDiagonal(size);
-
-        for (int i = 0; i < size; ++i) {
-            result->data[i] = data[i] - otherDiag->data[i];
-        }
-    
-        return result; 
+        return other.applyTo(Operation::Subtract, *this);
     }
 
     Matrix* elementwiseMultiply(const Matrix& other) const override {
-        const MatrixDiagonal* otherDiag = dynamic_cast<const MatrixDiagonal*>(&other);
-        checkSize(otherDiag);
-        
-        MatrixDiagonal* result = new MatrixDiagonal(size);
-
-        for (int i = 0; i < size; ++i) {
-            result->data[i] = data[i] * otherDiag->data[i];
-        }
-    
-        return result; 
+        return other.applyTo(Operation::ElementwiseMultiply, *this);
     }
 
     Matrix* multiply(const Matrix& other) const override {
-        const MatrixDiagonal* otherDiag = dynamic_cast<const MatrixDiagonal*>(&other);
-        checkSize(otherDiag);
-        
+        return other.applyTo(Operation::Multiply, *this);
+    }
+
+    // left op this для двух диагональных матриц: результат тоже диагональный
+    Matrix* applyTo(Operation op, const MatrixDiagonal& left) const override {
+        left.checkSize(this);
+
+        //Создание новой диагональной матрицы для хранения результата.
         MatrixDiagonal* result = new MatrixDiagonal(size);
 
+        //Операция над соответствующими элементами диагоналей двух матриц;
+        //матричное произведение диагональных - тоже поэлементное.
         for (int i = 0; i < size; ++i) {
-            result->data[i] = data[i] * otherDiag->data[i];
+            switch (op) {
+                case Operation::Add: result->data[i] = left.data[i] + data[i]; break;
+                case Operation::Subtract: result->data[i] = left.data[i] - data[i]; break;
+                default: result->data[i] = left.data[i] * data[i]; break;
+            }
+        }
+
+        return result;
+    }
+
+    // left op this, left - плотная: ядра пар из MatrixDense. Сумма и разность
+    // остаются плотными, произведение - плотное с масштабированными
+    // столбцами, поэлементное произведение - диагональное.
+    Matrix* applyTo(Operation op, const MatrixDense& left) const override {
+        switch (op) {
+            case Operation::Add: return left.addDiagonal(*this, 1.0, 1.0);
+            case Operation::Subtract: return left.addDiagonal(*this, 1.0, -1.0);
+            case Operation::ElementwiseMultiply: return left.multiplyDiagonal(*this);
+            default: return left.scaleColumns(*this);
         }
-    
-        return result; 
     }
 
     Matrix* transpose() const override {
@@ -312,3 +514,90 @@ public:
     }
 
 };
+
+// Ядра MatrixDense для пар с MatrixDiagonal: им нужны оба полных типа
+
+inline Matrix* MatrixDense::applyTo(Operation op, const MatrixDiagonal& left) const {
+    switch (op) {
+        case Operation::Add: return addDiagonal(left, 1.0, 1.0);
+        case Operation::Subtract: return addDiagonal(left, -1.0, 1.0);
+        case Operation::ElementwiseMultiply: return multiplyDiagonal(left);
+        default: return scaleRows(left);
+    }
+}
+
+inline MatrixDense* MatrixDense::scaleColumns(const MatrixDiagonal& diagonal) const {
+    checkMultiplySize(cols, diagonal.rowCount());
+    const double* scale = diagonal.diagonal().data();
+
+    MatrixDense* result = new MatrixDense(rows, cols, Uninitialized());
+    parallel::forEachRowBlock(rows, cols, [&](size_t begin, size_t end) {
+        for (int i = static_cast<int>(begin); i < static_cast<int>(end); ++i) {
+            const double* in = rowData(i);
+            double* out = result->rowData(i);
+            for (int j = 0; j < cols; ++j) {
+                out[j] = in[j] * scale[j];
+            }
+            std::fill(out + cols, out + ld, 0.0);
+        }
+    });
+    return result;
+}
+
+inline MatrixDense* MatrixDense::scaleRows(const MatrixDiagonal& diagonal) const {
+    checkMultiplySize(diagonal.colCount(), rows);
+    const double* scale = diagonal.diagonal().data();
+
+    MatrixDense* result = new MatrixDense(rows, cols, Uninitialized());
+    parallel::forEachRowBlock(rows, cols, [&](size_t begin, size_t end) {
+        for (int i = static_cast<int>(begin); i < static_cast<int>(end); ++i) {
+            const double* in = rowData(i);
+            double* out = result->rowData(i);
+            double factor = scale[i];
+            for (int j = 0; j < cols; ++j) {
+                out[j] = in[j] * factor;
+            }
+            std::fill(out + cols, out + ld, 0.0);
+        }
+    });
+    return result;
+}
+
+inline MatrixDense* MatrixDense::addDiagonal(const MatrixDiagonal& diagonal, double selfSign,
+                                             double diagonalSign) const {
+    if (rows != diagonal.rowCount() || cols != diagonal.colCount()) {
+        throw std::invalid_argument("Размеры матрицы не совпадают.");
+    }
+    const double* values = diagonal.diagonal().data();
+
+    MatrixDense* result = new MatrixDense(rows, cols, Uninitialized());
+    parallel::forEachRowBlock(rows, cols, [&](size_t begin, size_t end) {
+        for (int i = static_cast<int>(begin); i < static_cast<int>(end); ++i) {
+            const double* in = rowData(i);
+            double* out = result->rowData(i);
+            if (selfSign == 1.0) {
+                std::memcpy(out, in, cols * sizeof(double));
+            } else {
+                for (int j = 0; j < cols; ++j) {
+                    out[j] = selfSign * in[j];
+                }
+            }
+            out[i] += diagonalSign * values[i];
+            std::fill(out + cols, out + ld, 0.0);
+        }
+    });
+    return result;
+}
+
+inline MatrixDiagonal* MatrixDense::multiplyDiagonal(const MatrixDiagonal& diagonal) const {
+    if (rows != diagonal.rowCount() || cols != diagonal.colCount()) {
+        throw std::invalid_argument("Размеры матрицы не совпадают.");
+    }
+    const std::vector<double>& values = diagonal.diagonal();
+
+    MatrixDiagonal* result = new MatrixDiagonal(rows);
+    for (int i = 0; i < rows; ++i) {
+        result->set(i, i, (*this)(i, i) * values[i]);
+    }
+    return result;
+}
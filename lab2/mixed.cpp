@@ -0,0 +1,75 @@
+// Операции над плотной и диагональной матрицами: ядро выбирается по паре
+// типов операндов, и результат сохраняет самую разреженную верную форму.
+// Затем время умножения на диагональную матрицу сравнивается с умножением на
+// ту же матрицу, развернутую в плотную.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread mixed.cpp -o mixed.out
+// Запуск: ./mixed.out [размер]
+
+#include "matrix.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static const char* typeName(const Matrix& matrix) {
+    return dynamic_cast<const MatrixDiagonal*>(&matrix) ? "MatrixDiagonal" : "MatrixDense";
+}
+
+static void show(const char* title, const Matrix* matrix) {
+    std::cout << title << " (" << typeName(*matrix) << "):" << std::endl;
+    matrix->Print();
+    delete matrix;
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 2048;
+
+    try {
+        MatrixDense dense(3, 3);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                dense.set(i, j, i * 3 + j + 1);
+            }
+        }
+        MatrixDiagonal diagonal(3);
+        diagonal.set(0, 0, 2.0);
+        diagonal.set(1, 1, 10.0);
+        diagonal.set(2, 2, -1.0);
+
+        show("Плотная * диагональная: столбцы умножены", dense.multiply(diagonal));
+        show("Диагональная * плотная: строки умножены", diagonal.multiply(dense));
+        show("Плотная + диагональная", dense.add(diagonal));
+        show("Диагональная - плотная", diagonal.subtract(dense));
+        show("Поэлементное произведение", dense.elementwiseMultiply(diagonal));
+
+        MatrixDense big(n, n), expanded(n, n);
+        MatrixDiagonal scale(n);
+        for (int i = 0; i < n; ++i) {
+            scale.set(i, i, 1.0 + i % 7);
+            expanded(i, i) = 1.0 + i % 7;
+            for (int j = 0; j < n; ++j) {
+                big(i, j) = (i + j) % 13;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<Matrix> scaled(big.multiply(scale));
+        double fast = secondsSince(start);
+        start = std::chrono::steady_clock::now();
+        std::unique_ptr<Matrix> product(big.multiply(expanded));
+        double slow = secondsSince(start);
+        std::cout << n << " x " << n << ": умножение на диагональную " << fast * 1000
+                  << " мс, на развернутую плотную " << slow * 1000 << " мс" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
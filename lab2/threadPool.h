@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Параллельное выполнение операций над матрицами: общий пул потоков и
+// разбиение строк на блоки.
+namespace parallel {
+
+// Пул долгоживущих потоков: потоки создаются один раз, а каждый run() только
+// будит их, поэтому операции над матрицами не платят за создание std::thread.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;                 // защищает поля текущего задания
+    std::condition_variable wakeUp;   // будит рабочие потоки
+    std::condition_variable finished; // будит вызывающий поток
+    std::mutex runMutex;              // run() выполняется одним вызывающим за раз
+
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobTasks = 0;
+    size_t generation = 0;
+    bool stopping = false;
+
+    std::atomic<size_t> nextTask{0};
+    std::atomic<size_t> doneTasks{0};
+    size_t activeWorkers = 0; // рабочие, взявшие текущее задание
+    std::exception_ptr firstError;
+
+    static bool& insideWorker() {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    void drainTasks(const std::function<void(size_t)>& fn, size_t numTasks) {
+        for (size_t task = nextTask.fetch_add(1); task < numTasks; task = nextTask.fetch_add(1)) {
+            try {
+                fn(task);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+            doneTasks.fetch_add(1);
+        }
+    }
+
+    void workerLoop() {
+        insideWorker() = true;
+        size_t seenGeneration = 0;
+        while (true) {
+            const std::function<void(size_t)>* fn = nullptr;
+            size_t numTasks = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if (stopping) {
+                    return;
+                }
+                seenGeneration = generation;
+                fn = job;
+                numTasks = jobTasks;
+                if (!fn) {
+                    continue;
+                }
+                ++activeWorkers;
+            }
+            drainTasks(*fn, numTasks);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --activeWorkers;
+            }
+            finished.notify_one();
+        }
+    }
+
+public:
+    // numWorkers рабочих потоков; вызывающий поток run() работает вместе с
+    // ними, поэтому всего задачи выполняют numWorkers + 1 потоков
+    explicit ThreadPool(size_t numWorkers) {
+        workers.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; ++i) {
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& th : workers) {
+            th.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Число потоков, выполняющих задачи, включая вызывающий
+    size_t size() const {
+        return workers.size() + 1;
+    }
+
+    // Выполняет fn(task) для каждого task из [0, numTasks) и ждет завершения.
+    // Первое исключение из задач пробрасывается вызывающему.
+    void run(size_t numTasks, const std::function<void(size_t)>& fn) {
+        if (numTasks == 0) {
+            return;
+        }
+        // Вложенный вызов из задачи, одна задача или пул занят другим
+        // вызывающим: выполняем на месте
+        std::unique_lock<std::mutex> runLock(runMutex, std::defer_lock);
+        if (workers.empty() || insideWorker() || numTasks == 1 || !runLock.try_lock()) {
+            for (size_t task = 0; task < numTasks; ++task) {
+                fn(task);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobTasks = numTasks;
+            firstError = nullptr;
+            nextTask.store(0);
+            doneTasks.store(0);
+            ++generation;
+        }
+        wakeUp.notify_all();
+
+        drainTasks(fn, numTasks);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Ждем и выхода рабочих из задания, чтобы опоздавший поток не
+            // взял задачи следующего run() со старой fn
+            finished.wait(lock, [&] { return doneTasks.load() == numTasks && activeWorkers == 0; });
+            job = nullptr;
+            error = firstError;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+namespace detail {
+
+inline size_t hardwareThreads() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+struct SharedPool {
+    std::mutex mutex;
+    size_t numThreads = hardwareThreads();
+    std::unique_ptr<ThreadPool> pool;
+};
+
+inline SharedPool& shared() {
+    static SharedPool state;
+    return state;
+}
+
+} // namespace detail
+
+// Число потоков для операций над матрицами; по умолчанию - число аппаратных
+// потоков
+inline size_t threadCount() {
+    auto& state = detail::shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.numThreads;
+}
+
+// Задает число потоков (0 - по числу аппаратных потоков). Пул пересоздается
+// при следующей операции, поэтому вызывать нельзя, пока операции над
+// матрицами выполняются в других потоках.
+inline void setThreadCount(size_t numThreads) {
+    auto& state = detail::shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    numThreads = numThreads == 0 ? detail::hardwareThreads() : numThreads;
+    if (numThreads != state.numThreads) {
+        state.numThreads = numThreads;
+        state.pool.reset();
+    }
+}
+
+// Общий пул на threadCount() потоков
+inline ThreadPool& pool() {
+    auto& state = detail::shared();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.pool) {
+        state.pool = std::make_unique<ThreadPool>(state.numThreads - 1);
+    }
+    return *state.pool;
+}
+
+// Операция над строками [0, rows), каждая из которых стоит около rowCost
+// элементарных действий. Строки режутся на блоки не меньше minBlockCost
+// действий, по несколько блоков на поток для выравнивания нагрузки, и блоки
+// выполняет общий пул: fn(begin, end). Маленькие матрицы считаются в
+// вызывающем потоке.
+inline void forEachRowBlock(size_t rows, size_t rowCost, const std::function<void(size_t, size_t)>& fn) {
+    constexpr size_t minBlockCost = size_t(1) << 15;
+    constexpr size_t blocksPerThread = 4;
+    if (rows == 0) {
+        return;
+    }
+    size_t numThreads = threadCount();
+    size_t minRows = std::max<size_t>(1, minBlockCost / std::max<size_t>(1, rowCost));
+    size_t numBlocks = std::min(numThreads * blocksPerThread, (rows + minRows - 1) / minRows);
+    if (numThreads == 1 || numBlocks <= 1) {
+        fn(0, rows);
+        return;
+    }
+    size_t blockRows = (rows + numBlocks - 1) / numBlocks;
+    numBlocks = (rows + blockRows - 1) / blockRows;
+    pool().run(numBlocks, [&](size_t block) {
+        size_t begin = block * blockRows;
+        fn(begin, std::min(rows, begin + blockRows));
+    });
+}
+
+} // namespace parallel
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gemm.h"
+
+// Транспонирование плотных строчных матриц блоками.
+//
+// Наивный цикл пишет результат по столбцам: каждая запись попадает в новую
+// строку кэша и часто в новую страницу. Здесь матрица обходится блоками, у
+// которых и исходный, и результирующий участок помещаются в L1 вместе, а
+// внутри блока плитки 8 x 8 (AVX-512) или 4 x 4 (AVX2) транспонируются в
+// регистрах: строки плитки загружаются векторами, переставляются
+// перестановками и записываются векторами в строки результата. Набор
+// инструкций выбирается во время выполнения, как у gemm.
+//
+// Результат больше кэша пишется потоковыми (non-temporal) записями: строки
+// результата не читаются в кэш перед записью и не вытесняют исходную
+// матрицу, поэтому копирование с транспонированием идет со скоростью memcpy.
+namespace transposition {
+
+// Блок копирования: короткий по строкам источника (их строки кэша должны
+// дожить до следующей плитки), длинный по столбцам, чтобы чтение шло
+// длинными последовательными участками
+constexpr size_t copyBlockRows = 16;
+constexpr size_t copyBlockCols = 256;
+// Квадратный блок транспонирования на месте
+constexpr size_t blockSize = 32;
+// Результат от этого размера в байтах пишется потоковыми записями
+constexpr size_t streamingBytes = size_t(1) << 20;
+
+namespace detail {
+
+// Скалярная плитка произвольного размера: dst[j][i] = src[i][j]
+inline void tileScalar(const double* src, size_t lds, double* dst, size_t ldd, size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+#if MATRIX_GEMM_X86
+
+// 4 x 4: чередование пар строк, затем обмен 128-битными половинами. Для
+// потоковой записи строки dst выровнены по 32 байта.
+template<bool Stream>
+__attribute__((target("avx2")))
+inline void store4(double* dst, __m256d value) {
+    if (Stream) {
+        _mm256_stream_pd(dst, value);
+    } else {
+        _mm256_storeu_pd(dst, value);
+    }
+}
+
+template<bool Stream>
+__attribute__((target("avx2")))
+inline void tileAvx2(const double* src, size_t lds, double* dst, size_t ldd) {
+    __m256d r0 = _mm256_loadu_pd(src);
+    __m256d r1 = _mm256_loadu_pd(src + lds);
+    __m256d r2 = _mm256_loadu_pd(src + 2 * lds);
+    __m256d r3 = _mm256_loadu_pd(src + 3 * lds);
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1); // a0 b0 a2 b2
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1); // a1 b1 a3 b3
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3); // c0 d0 c2 d2
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3); // c1 d1 c3 d3
+    store4<Stream>(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+    store4<Stream>(dst + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+    store4<Stream>(dst + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+    store4<Stream>(dst + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+// 8 x 8: чередование пар строк, затем два шага перестановки 128-битных
+// частей векторов. Для потоковой записи строки dst выровнены по 64 байта.
+template<bool Stream>
+__attribute__((target("avx512f")))
+inline void store8(double* dst, __m512d value) {
+    if (Stream) {
+        _mm512_stream_pd(dst, value);
+    } else {
+        _mm512_storeu_pd(dst, value);
+    }
+}
+
+template<bool Stream>
+__attribute__((target("avx512f")))
+inline void tileAvx512(const double* src, size_t lds, double* dst, size_t ldd) {
+    // Формы с маской на все элементы: у немаскированных GCC 12 ложно
+    // предупреждает о неинициализированном операнде
+    constexpr __mmask8 allLanes = 0xff;
+    __m512d r[8];
+    for (size_t i = 0; i < 8; ++i) {
+        r[i] = _mm512_loadu_pd(src + i * lds);
+    }
+    __m512d t[8];
+    for (size_t i = 0; i < 8; i += 2) {
+        t[i] = _mm512_maskz_unpacklo_pd(allLanes, r[i], r[i + 1]);     // x0 y0 x2 y2 x4 y4 x6 y6
+        t[i + 1] = _mm512_maskz_unpackhi_pd(allLanes, r[i], r[i + 1]); // x1 y1 x3 y3 x5 y5 x7 y7
+    }
+    // Пары строк a,b и c,d: столбцы 0/4, 2/6, 1/5, 3/7; так же для e,f и g,h
+    __m512d u[8];
+    for (size_t half = 0; half < 8; half += 4) {
+        u[half] = _mm512_maskz_shuffle_f64x2(allLanes, t[half], t[half + 2], 0x88);
+        u[half + 1] = _mm512_maskz_shuffle_f64x2(allLanes, t[half], t[half + 2], 0xDD);
+        u[half + 2] = _mm512_maskz_shuffle_f64x2(allLanes, t[half + 1], t[half + 3], 0x88);
+        u[half + 3] = _mm512_maskz_shuffle_f64x2(allLanes, t[half + 1], t[half + 3], 0xDD);
+    }
+    // Номер столбца результата для каждой из четырех пар u[q], u[q + 4]
+    static constexpr size_t firstColumn[4] = {0, 2, 1, 3};
+    for (size_t q = 0; q < 4; ++q) {
+        size_t j = firstColumn[q];
+        store8<Stream>(dst + j * ldd, _mm512_maskz_shuffle_f64x2(allLanes, u[q], u[q + 4], 0x88));
+        store8<Stream>(dst + (j + 4) * ldd, _mm512_maskz_shuffle_f64x2(allLanes, u[q], u[q + 4], 0xDD));
+    }
+}
+
+#endif
+
+// Сторона плитки, которую транспонирует runTile
+inline size_t tileSize(gemm::Kernel kernel) {
+    return kernel == gemm::Kernel::AVX512 ? 8 : 4;
+}
+
+template<bool Stream = false>
+inline void runTile(gemm::Kernel kernel, const double* src, size_t lds, double* dst, size_t ldd) {
+#if MATRIX_GEMM_X86
+    if (kernel == gemm::Kernel::AVX512) {
+        tileAvx512<Stream>(src, lds, dst, ldd);
+        return;
+    }
+    if (kernel == gemm::Kernel::AVX2) {
+        tileAvx2<Stream>(src, lds, dst, ldd);
+        return;
+    }
+#endif
+    tileScalar(src, lds, dst, ldd, 4, 4);
+}
+
+template<bool Stream>
+inline void copyBlocks(gemm::Kernel kernel, size_t rows, size_t cols, const double* src, size_t lds, double* dst,
+                       size_t ldd) {
+    size_t t = tileSize(kernel);
+    for (size_t i0 = 0; i0 < rows; i0 += copyBlockRows) {
+        size_t blockRows = std::min(copyBlockRows, rows - i0);
+        size_t fullRows = blockRows / t * t;
+        for (size_t j0 = 0; j0 < cols; j0 += copyBlockCols) {
+            size_t blockCols = std::min(copyBlockCols, cols - j0);
+            size_t fullCols = blockCols / t * t;
+            const double* from = src + i0 * lds + j0;
+            double* to = dst + j0 * ldd + i0;
+            for (size_t i = 0; i < fullRows; i += t) {
+                for (size_t j = 0; j < fullCols; j += t) {
+                    runTile<Stream>(kernel, from + i * lds + j, lds, to + j * ldd + i, ldd);
+                }
+            }
+            // Края блока, не кратные плитке
+            tileScalar(from + fullCols, lds, to + fullCols * ldd, ldd, fullRows, blockCols - fullCols);
+            tileScalar(from + fullRows * lds, lds, to + fullRows, ldd, blockRows - fullRows, blockCols);
+        }
+    }
+}
+
+} // namespace detail
+
+// dst (cols x rows) = src (rows x cols) транспонированная; участки памяти не
+// пересекаются
+inline void copy(size_t rows, size_t cols, const double* src, size_t lds, double* dst, size_t ldd) {
+    gemm::Kernel kernel = gemm::detectKernel();
+#if MATRIX_GEMM_X86
+    // Потоковые записи требуют выровненных строк результата: начало по 64
+    // байта, ведущая размерность кратна 8
+    bool aligned = reinterpret_cast<uintptr_t>(dst) % 64 == 0 && ldd % 8 == 0;
+    if (kernel != gemm::Kernel::Scalar && aligned && cols * ldd * sizeof(double) >= streamingBytes) {
+        detail::copyBlocks<true>(kernel, rows, cols, src, lds, dst, ldd);
+        _mm_sfence();
+        return;
+    }
+#endif
+    detail::copyBlocks<false>(kernel, rows, cols, src, lds, dst, ldd);
+}
+
+// Транспонирование на месте квадратной матрицы n x n: плитки выше и ниже
+// диагонали меняются местами парами через буфер плитки. Обрабатываются
+// пары блоков (I, J), J >= I, для блоков I из [blockBegin, blockEnd), так что
+// разные диапазоны блоков можно транспонировать параллельно.
+inline void inPlace(size_t n, double* data, size_t ld, size_t blockBegin, size_t blockEnd) {
+    gemm::Kernel kernel = gemm::detectKernel();
+    size_t t = detail::tileSize(kernel);
+    size_t full = n / t * t;
+    alignas(64) double first[64], second[64];
+
+    for (size_t bi = blockBegin; bi < blockEnd; ++bi) {
+        size_t i0 = bi * blockSize;
+        size_t iEnd = std::min(full, i0 + blockSize);
+        for (size_t j0 = i0; j0 < full; j0 += blockSize) {
+            size_t jEnd = std::min(full, j0 + blockSize);
+            for (size_t i = i0; i < iEnd; i += t) {
+                for (size_t j = std::max(j0, i); j < jEnd; j += t) {
+                    double* upper = data + i * ld + j;
+                    double* lower = data + j * ld + i;
+                    detail::runTile(kernel, upper, ld, first, t);
+                    if (i != j) {
+                        detail::runTile(kernel, lower, ld, second, t);
+                        for (size_t r = 0; r < t; ++r) {
+                            std::memcpy(upper + r * ld, second + r * t, t * sizeof(double));
+                        }
+                    }
+                    for (size_t r = 0; r < t; ++r) {
+                        std::memcpy(lower + r * ld, first + r * t, t * sizeof(double));
+                    }
+                }
+            }
+        }
+        // Хвостовые столбцы [full, n), не кратные плитке, и угол за ними
+        for (size_t i = i0; i < std::min(n, i0 + blockSize); ++i) {
+            for (size_t j = std::max(full, i + 1); j < n; ++j) {
+                std::swap(data[i * ld + j], data[j * ld + i]);
+            }
+        }
+    }
+}
+
+// Число блоков для inPlace
+inline size_t blockCount(size_t n) {
+    return (n + blockSize - 1) / blockSize;
+}
+
+} // namespace transposition
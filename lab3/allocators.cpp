@@ -0,0 +1,91 @@
+// Сравнение политик выделения буфера Vector (allocators.h): время выделения
+// с первым касанием страниц, последовательная сумма и чтение в случайном
+// порядке с промахами dTLB, а также цикл короткоживущих векторов, в котором
+// виден выигрыш пула буферов.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread allocators.cpp -o allocators.out
+// Запуск: ./allocators.out [размер] [проходов] [итераций цикла]
+
+#include "perfCounters.h"
+#include "random.h"
+#include "vector.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static volatile double sink;
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Счетчики открываются в главном потоке, поэтому измеряемые проходы
+// выполняются в нем же, без пула
+template<typename Allocator>
+void measure(size_t n, size_t passes, size_t iterations, const std::vector<size_t>& randomOrder) {
+    auto start = std::chrono::steady_clock::now();
+    Vector<double, Allocator> vec(n);
+    vec.initializeRandom(0.0, 1.0, 42, ThreadPool::instance().size());
+    double allocateMs = secondsSince(start) * 1000;
+
+    VectorView<double> view = vec.view();
+
+    PerfCounters sequential;
+    sequential.start();
+    start = std::chrono::steady_clock::now();
+    for (size_t pass = 0; pass < passes; ++pass) {
+        sink = sink + vec.calculateSum();
+    }
+    double sequentialSeconds = secondsSince(start);
+    sequential.stop();
+
+    PerfCounters gather;
+    gather.start();
+    start = std::chrono::steady_clock::now();
+    double sum = 0;
+    for (size_t index : randomOrder) {
+        sum += view[index];
+    }
+    sink = sink + sum;
+    double gatherSeconds = secondsSince(start);
+    gather.stop();
+
+    // Короткоживущие векторы по 1/16 основного размера
+    size_t small = std::max<size_t>(1, n / 16);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        Vector<double, Allocator> temp(small);
+        temp.initializeConstant(1.0);
+        sink = sink + temp.calculateSum();
+    }
+    double churnUs = secondsSince(start) * 1e6 / static_cast<double>(iterations);
+
+    double gigabytes = static_cast<double>(n) * sizeof(double) * passes / 1e9;
+    std::cout << Allocator::name() << "\t" << allocateMs << "\t" << gigabytes / sequentialSeconds << "\t"
+              << sequential.format(PerfCounters::DTLBMisses) << "\t" << gatherSeconds * 1e9 / randomOrder.size() << "\t"
+              << gather.format(PerfCounters::DTLBMisses) << "\t" << churnUs << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(20) << 20;
+    size_t passes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+    size_t iterations = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200;
+
+    // Одинаковый для всех политик порядок чтения
+    Philox4x32 generator(7);
+    std::vector<size_t> randomOrder(std::min<size_t>(n, size_t(1) << 22));
+    for (size_t i = 0; i < randomOrder.size(); ++i) {
+        randomOrder[i] = uniformFromBits<size_t>(generator.bits(i), 0, n - 1);
+    }
+
+    std::cout << "политика\tвыделение, мс\tсумма, ГБ/с\tsum dTLB-misses\tслучайное чтение, нс\tgather dTLB-misses"
+              << "\tцикл, мкс\n";
+    measure<allocators::AlignedAllocator>(n, passes, iterations, randomOrder);
+    measure<allocators::TransparentHugePageAllocator>(n, passes, iterations, randomOrder);
+    measure<allocators::HugeTlbAllocator>(n, passes, iterations, randomOrder);
+    measure<allocators::NumaInterleavedAllocator>(n, passes, iterations, randomOrder);
+    measure<allocators::PoolAllocator<>>(n, passes, iterations, randomOrder);
+    return 0;
+}
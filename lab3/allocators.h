@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+// Политики выделения памяти для буфера Vector. Политика - класс со
+// статическими функциями
+//     template<typename T> static T* allocate(size_t count);
+//     template<typename T> static void deallocate(T* data, size_t count);
+//     static const char* name();
+// Память не инициализируется (как new T[count] для арифметических T).
+// Политики без состояния, поэтому Vector разных политик не различаются по размеру.
+namespace allocators {
+
+// Выравнивание под строку кэша и самые широкие векторные загрузки (AVX-512)
+constexpr size_t simdAlignment = 64;
+// Размер большой страницы x86-64 и arm64 с 4-КБ базовыми страницами
+constexpr size_t hugePageSize = size_t(2) << 20;
+
+inline size_t roundUp(size_t bytes, size_t multiple) {
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+// Выравнивание по 64 байтам через выравнивающий operator new
+struct AlignedAllocator {
+    template<typename T>
+    static T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(simdAlignment)));
+    }
+
+    template<typename T>
+    static void deallocate(T* data, size_t) {
+        ::operator delete(data, std::align_val_t(simdAlignment));
+    }
+
+    static const char* name() { return "aligned"; }
+};
+
+namespace detail {
+
+// Анонимное отображение, начало которого выровнено по 2 МБ: лишнее
+// выделяется с запасом и обрезается, чтобы ядро могло отдать большие страницы
+inline void* mapHugeAligned(size_t bytes) {
+    size_t length = roundUp(bytes, hugePageSize);
+    void* raw = mmap(nullptr, length + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = roundUp(begin, hugePageSize);
+    if (aligned > begin) {
+        munmap(raw, aligned - begin);
+    }
+    uintptr_t tail = aligned + length;
+    uintptr_t end = begin + length + hugePageSize;
+    if (end > tail) {
+        munmap(reinterpret_cast<void*>(tail), end - tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+inline void unmapHuge(void* data, size_t bytes) {
+    if (data) {
+        munmap(data, roundUp(bytes, hugePageSize));
+    }
+}
+
+} // namespace detail
+
+// Прозрачные большие страницы: выровненное отображение и madvise(MADV_HUGEPAGE).
+// Работает при transparent_hugepage в режиме always или madvise; иначе
+// остаются обычные страницы.
+struct TransparentHugePageAllocator {
+    template<typename T>
+    static T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        void* data = detail::mapHugeAligned(bytes);
+#ifdef MADV_HUGEPAGE
+        madvise(data, roundUp(bytes, hugePageSize), MADV_HUGEPAGE);
+#endif
+        return static_cast<T*>(data);
+    }
+
+    template<typename T>
+    static void deallocate(T* data, size_t count) {
+        detail::unmapHuge(data, count * sizeof(T));
+    }
+
+    static const char* name() { return "thp"; }
+};
+
+// Явные 2-МБ страницы из пула hugetlbfs (MAP_HUGETLB). Пул настраивается
+// администратором (vm.nr_hugepages); если страниц не хватает, используются
+// прозрачные большие страницы.
+struct HugeTlbAllocator {
+    template<typename T>
+    static T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+#ifdef MAP_HUGETLB
+        void* data = mmap(nullptr, roundUp(bytes, hugePageSize), PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED) {
+            return static_cast<T*>(data);
+        }
+#endif
+        return TransparentHugePageAllocator::allocate<T>(count);
+    }
+
+    template<typename T>
+    static void deallocate(T* data, size_t count) {
+        // Оба варианта - отображения длиной, кратной 2 МБ
+        detail::unmapHuge(data, count * sizeof(T));
+    }
+
+    static const char* name() { return "hugetlb"; }
+};
+
+// Страницы распределяются по NUMA-узлам по очереди (mbind с MPOL_INTERLEAVE),
+// чтобы потоки со всех сокетов читали буфер с общей пропускной способностью
+// всех контроллеров памяти. Политика задается до первого касания страниц,
+// поэтому заменяет размещение first touch из initializeRandom. На системе с
+// одним узлом или без поддержки NUMA это обычное выровненное отображение.
+struct NumaInterleavedAllocator {
+    template<typename T>
+    static T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        void* data = detail::mapHugeAligned(bytes);
+#ifdef __linux__
+        // Маска первых 64 узлов; ядро оставляет в ней только узлы с памятью,
+        // доступные процессу. maxnode на единицу больше числа бит маски, так
+        // как ядро уменьшает его перед разбором. Ошибка не критична: останется
+        // размещение по умолчанию.
+        constexpr unsigned long interleave = 3; // MPOL_INTERLEAVE из <linux/mempolicy.h>
+        unsigned long nodeMask = ~0UL;
+        syscall(SYS_mbind, data, roundUp(bytes, hugePageSize), interleave, &nodeMask, sizeof(nodeMask) * 8 + 1, 0);
+#endif
+        return static_cast<T*>(data);
+    }
+
+    template<typename T>
+    static void deallocate(T* data, size_t count) {
+        detail::unmapHuge(data, count * sizeof(T));
+    }
+
+    static const char* name() { return "numa-interleave"; }
+};
+
+// Пул буферов по классам размеров (степени двойки, от 4 КБ) поверх политики
+// Base. Освобожденный буфер остается в списке своего класса и отдается
+// следующему вектору того же класса, поэтому короткоживущие векторы в цикле
+// заданий не обращаются к malloc/mmap и не получают заново нулевые страницы
+// от ядра. Пул общий для всех векторов с этой политикой; в нем хранится не
+// больше maxCachedBytes, остальное сразу возвращается Base.
+template<typename Base = AlignedAllocator>
+class PoolAllocator {
+private:
+    static constexpr size_t minClassBytes = size_t(4) << 10;
+    static constexpr size_t classCount = 48;
+    static constexpr size_t maxCachedBytes = size_t(1) << 30;
+
+    struct Pool {
+        std::mutex lock;
+        std::vector<void*> freeLists[classCount];
+        size_t cachedBytes = 0;
+
+        ~Pool() {
+            for (size_t c = 0; c < classCount; ++c) {
+                for (void* block : freeLists[c]) {
+                    Base::template deallocate<char>(static_cast<char*>(block), classBytes(c));
+                }
+            }
+        }
+    };
+
+    static Pool& pool() {
+        static Pool instance;
+        return instance;
+    }
+
+    static size_t sizeClass(size_t bytes) {
+        size_t c = 0;
+        while (c + 1 < classCount && (minClassBytes << c) < bytes) {
+            ++c;
+        }
+        return c;
+    }
+
+    static size_t classBytes(size_t c) {
+        return minClassBytes << c;
+    }
+
+public:
+    template<typename T>
+    static T* allocate(size_t count) {
+        size_t c = sizeClass(count * sizeof(T));
+        Pool& p = pool();
+        {
+            std::lock_guard<std::mutex> guard(p.lock);
+            if (!p.freeLists[c].empty()) {
+                void* block = p.freeLists[c].back();
+                p.freeLists[c].pop_back();
+                p.cachedBytes -= classBytes(c);
+                return static_cast<T*>(block);
+            }
+        }
+        return reinterpret_cast<T*>(Base::template allocate<char>(classBytes(c)));
+    }
+
+    template<typename T>
+    static void deallocate(T* data, size_t count) {
+        if (!data) {
+            return;
+        }
+        size_t c = sizeClass(count * sizeof(T));
+        Pool& p = pool();
+        {
+            std::lock_guard<std::mutex> guard(p.lock);
+            if (p.cachedBytes + classBytes(c) <= maxCachedBytes) {
+                p.freeLists[c].push_back(data);
+                p.cachedBytes += classBytes(c);
+                return;
+            }
+        }
+        Base::template deallocate<char>(reinterpret_cast<char*>(data), classBytes(c));
+    }
+
+    // Возвращает все закэшированные буферы политике Base
+    static void trim() {
+        Pool& p = pool();
+        std::lock_guard<std::mutex> guard(p.lock);
+        for (size_t c = 0; c < classCount; ++c) {
+            for (void* block : p.freeLists[c]) {
+                Base::template deallocate<char>(static_cast<char*>(block), classBytes(c));
+            }
+            p.freeLists[c].clear();
+        }
+        p.cachedBytes = 0;
+    }
+
+    static const char* name() { return "pool"; }
+};
+
+} // namespace allocators
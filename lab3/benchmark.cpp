@@ -0,0 +1,297 @@
+// Набор бенчмарков операций Vector. Перебирает тип элементов, размер
+// вектора, число потоков и расписание; для каждой комбинации делает прогрев
+// и несколько повторов, выводит медиану и 99-й перцентиль времени,
+// пропускную способность (ГБ/с) и ускорение относительно последовательной
+// версии. Результат в CSV или JSON, чтобы сравнивать сборки между собой.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark.out
+// Запуск: ./benchmark.out [--types=double,float,int32,int64,int16,int8,half,bf16]
+//                         [--sizes=1000,1000000,...] [--threads=1,2,4,...]
+//                         [--schedules=static,dynamic,guided,stealing]
+//                         [--ops=min,max,sum,sum-det,mean,describe,sum-spawn]
+//                         [--warmup=3] [--reps=20] [--format=csv|json] [--out=файл]
+//
+// Операция sum-spawn - сумма с созданием std::thread на каждый вызов, как было
+// до пула потоков; ее сравнение с sum показывает цену запуска потоков.
+// Операция sum-det - воспроизводимая сумма (calculateSumDeterministic), ее
+// сравнение с sum показывает цену независимости от числа потоков; как и
+// остальные операции, она измеряется при каждом расписании из --schedules.
+
+#include "vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Config {
+    std::vector<std::string> types = {"double", "float", "int32", "int64"};
+    std::vector<size_t> sizes = {1000, 100000, 10000000};
+    std::vector<size_t> threads;
+    std::vector<scheduler::Schedule> schedules = {scheduler::Schedule::Static, scheduler::Schedule::Dynamic,
+                                                  scheduler::Schedule::Guided, scheduler::Schedule::WorkStealing};
+    std::vector<std::string> operations = {"min", "max", "sum", "sum-det", "mean", "describe", "sum-spawn"};
+    size_t warmup = 3;
+    size_t repetitions = 20;
+    std::string format = "csv";
+    std::string output;
+};
+
+struct Result {
+    std::string type;
+    std::string operation;
+    size_t size = 0;
+    size_t threads = 0;      // 0 - последовательная версия
+    std::string schedule;
+    double median = 0;
+    double p99 = 0;
+    double gigabytesPerSecond = 0;
+    double speedup = 1;
+};
+
+static std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static scheduler::Schedule parseSchedule(const std::string& name) {
+    for (auto schedule : {scheduler::Schedule::Static, scheduler::Schedule::Dynamic,
+                          scheduler::Schedule::Guided, scheduler::Schedule::WorkStealing}) {
+        if (name == scheduler::scheduleName(schedule)) {
+            return schedule;
+        }
+    }
+    throw std::invalid_argument("Неизвестное расписание: " + name);
+}
+
+static Config parseArguments(int argc, char** argv) {
+    Config config;
+    for (size_t t = 1; t <= ThreadPool::instance().size(); t *= 2) {
+        config.threads.push_back(t);
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        size_t eq = argument.find('=');
+        if (argument.rfind("--", 0) != 0 || eq == std::string::npos) {
+            throw std::invalid_argument("Неверный аргумент: " + argument);
+        }
+        std::string key = argument.substr(2, eq - 2);
+        std::string value = argument.substr(eq + 1);
+        if (key == "types") {
+            config.types = splitList(value);
+        } else if (key == "sizes" || key == "threads") {
+            std::vector<size_t>& target = key == "sizes" ? config.sizes : config.threads;
+            target.clear();
+            for (const auto& item : splitList(value)) {
+                target.push_back(std::stoull(item));
+            }
+        } else if (key == "schedules") {
+            config.schedules.clear();
+            for (const auto& item : splitList(value)) {
+                config.schedules.push_back(parseSchedule(item));
+            }
+        } else if (key == "ops") {
+            config.operations = splitList(value);
+        } else if (key == "warmup") {
+            config.warmup = std::stoull(value);
+        } else if (key == "reps") {
+            config.repetitions = std::max<size_t>(1, std::stoull(value));
+        } else if (key == "format") {
+            config.format = value;
+        } else if (key == "out") {
+            config.output = value;
+        } else {
+            throw std::invalid_argument("Неизвестный параметр: " + key);
+        }
+    }
+    return config;
+}
+
+// Времена повторов в секундах после прогрева
+static std::vector<double> sample(const Config& config, const std::function<void()>& call) {
+    for (size_t i = 0; i < config.warmup; ++i) {
+        call();
+    }
+    std::vector<double> samples;
+    samples.reserve(config.repetitions);
+    for (size_t i = 0; i < config.repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        call();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+// Сумма с созданием потоков на каждый вызов (прежняя реализация)
+template<typename T>
+static numeric::Accumulator<T> sumSpawn(const T* data, size_t n, size_t numThreads) {
+    std::vector<std::thread> threads;
+    std::vector<numeric::Accumulator<T>> allSum(numThreads);
+    size_t chunkSize = n / numThreads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        size_t start = i * chunkSize;
+        size_t end = (i == numThreads - 1) ? n : (i + 1) * chunkSize;
+        threads.emplace_back([&, i, start, end] { allSum[i] = simd::sum(data + start, end - start); });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    numeric::Accumulator<T> sum = 0;
+    for (auto part : allSum) {
+        sum += part;
+    }
+    return sum;
+}
+
+// Не дает компилятору выбросить результат операции
+static volatile double sink;
+
+template<typename T>
+static void runType(const Config& config, const std::string& typeName, std::vector<Result>& results) {
+    for (size_t size : config.sizes) {
+        Vector<T> vec(size);
+        vec.initializeRandom(T(0), T(100), 42, ThreadPool::instance().size());
+        // Данные для sum-spawn: тот же вектор, скопированный в обычный массив
+        std::vector<T> raw(size);
+        vec.parallelForEach([&](T value, size_t i) { raw[i] = value; });
+
+        for (const auto& operation : config.operations) {
+            std::function<void()> serial;
+            std::function<void(size_t, scheduler::Schedule)> parallel;
+            if (operation == "min") {
+                serial = [&] { sink = static_cast<double>(vec.findMin().first); };
+                parallel = [&](size_t t, scheduler::Schedule s) { sink = static_cast<double>(std::get<0>(vec.findMinParallel(t, s))); };
+            } else if (operation == "max") {
+                serial = [&] { sink = static_cast<double>(vec.findMax().first); };
+                parallel = [&](size_t t, scheduler::Schedule s) { sink = static_cast<double>(std::get<0>(vec.findMaxParallel(t, s))); };
+            } else if (operation == "sum") {
+                serial = [&] { sink = static_cast<double>(vec.calculateSum()); };
+                parallel = [&](size_t t, scheduler::Schedule s) { sink = static_cast<double>(vec.calculateSumParallel(t, s)); };
+            } else if (operation == "sum-det") {
+                serial = [&] { sink = static_cast<double>(vec.calculateSumDeterministic(1)); };
+                parallel = [&](size_t t, scheduler::Schedule s) { sink = static_cast<double>(vec.calculateSumDeterministic(t, s)); };
+            } else if (operation == "mean") {
+                serial = [&] { sink = static_cast<double>(vec.calculateMean()); };
+                parallel = [&](size_t t, scheduler::Schedule s) { sink = static_cast<double>(vec.calculateMeanParallel(t, s)); };
+            } else if (operation == "describe") {
+                serial = [&] { sink = vec.describe().mean; };
+                parallel = [&](size_t t, scheduler::Schedule s) { sink = vec.describeParallel(t, s).mean; };
+            } else if (operation == "sum-spawn") {
+                serial = [&] { sink = static_cast<double>(vec.calculateSum()); };
+                parallel = [&](size_t t, scheduler::Schedule) { sink = static_cast<double>(sumSpawn(raw.data(), size, t)); };
+            } else {
+                throw std::invalid_argument("Неизвестная операция: " + operation);
+            }
+
+            double bytes = static_cast<double>(size) * sizeof(T);
+            auto serialSamples = sample(config, serial);
+            double serialMedian = percentile(serialSamples, 0.5);
+            results.push_back({typeName, operation, size, 0, "serial", serialMedian, percentile(serialSamples, 0.99),
+                               bytes / serialMedian / 1e9, 1.0});
+
+            // Для sum-spawn расписание не используется, достаточно одного прогона
+            std::vector<scheduler::Schedule> schedules = config.schedules;
+            if (operation == "sum-spawn") {
+                schedules = {scheduler::Schedule::Static};
+            }
+            for (size_t t : config.threads) {
+                for (auto schedule : schedules) {
+                    auto samples = sample(config, [&] { parallel(t, schedule); });
+                    double median = percentile(samples, 0.5);
+                    results.push_back({typeName, operation, size, t, scheduler::scheduleName(schedule), median,
+                                       percentile(samples, 0.99), bytes / median / 1e9, serialMedian / median});
+                }
+            }
+        }
+    }
+}
+
+static void writeCsv(std::ostream& out, const std::vector<Result>& results) {
+    out << "type,operation,size,threads,schedule,median_s,p99_s,gb_per_s,speedup\n";
+    for (const auto& r : results) {
+        out << r.type << "," << r.operation << "," << r.size << "," << r.threads << "," << r.schedule << ","
+            << r.median << "," << r.p99 << "," << r.gigabytesPerSecond << "," << r.speedup << "\n";
+    }
+}
+
+static void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    out << "{\n  \"isa\": \"" << simd::isaName(simd::detectIsa()) << "\",\n"
+        << "  \"poolThreads\": " << ThreadPool::instance().size() << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\"type\": \"" << r.type << "\", \"operation\": \"" << r.operation << "\", \"size\": " << r.size
+            << ", \"threads\": " << r.threads << ", \"schedule\": \"" << r.schedule << "\", \"median_s\": " << r.median
+            << ", \"p99_s\": " << r.p99 << ", \"gb_per_s\": " << r.gigabytesPerSecond << ", \"speedup\": " << r.speedup
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    try {
+        Config config = parseArguments(argc, argv);
+        std::vector<Result> results;
+        for (const auto& type : config.types) {
+            if (type == "double") {
+                runType<double>(config, type, results);
+            } else if (type == "float") {
+                runType<float>(config, type, results);
+            } else if (type == "int32") {
+                runType<int32_t>(config, type, results);
+            } else if (type == "int64") {
+                runType<int64_t>(config, type, results);
+            } else if (type == "int16") {
+                runType<int16_t>(config, type, results);
+            } else if (type == "int8") {
+                runType<int8_t>(config, type, results);
+            } else if (type == "half") {
+                runType<numeric::half>(config, type, results);
+            } else if (type == "bf16") {
+                runType<numeric::bfloat16>(config, type, results);
+            } else {
+                throw std::invalid_argument("Неизвестный тип: " + type);
+            }
+        }
+
+        std::ofstream file;
+        if (!config.output.empty()) {
+            file.open(config.output);
+            if (!file) {
+                throw std::ios_base::failure("Не удается открыть файл " + config.output);
+            }
+        }
+        std::ostream& out = config.output.empty() ? std::cout : file;
+        out.precision(6);
+        if (config.format == "json") {
+            writeJson(out, results);
+        } else {
+            writeCsv(out, results);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "numeric.h"
+#include "paddedSlots.h"
+#include "threadPool.h"
+
+// Двоичный формат файла вектора, версия 1:
+//   64-байтный заголовок BinaryHeader, затем count элементов подряд.
+// Данные начинаются со смещения 64, поэтому отображенный в память файл
+// выровнен под загрузки SIMD и его можно использовать как буфер напрямую.
+namespace binary {
+
+constexpr char magic[8] = {'V', 'E', 'C', 'T', 'O', 'R', 'B', 'N'};
+constexpr uint32_t currentVersion = 1;
+constexpr uint32_t endianMarker = 0x01020304;
+
+enum TypeTag : uint32_t {
+    Unknown = 0,
+    Int8 = 1, Uint8 = 2, Int16 = 3, Uint16 = 4,
+    Int32 = 5, Uint32 = 6, Int64 = 7, Uint64 = 8,
+    Float32 = 9, Float64 = 10,
+    Float16 = 11, BFloat16 = 12,
+};
+
+template<typename T>
+constexpr TypeTag typeTag() {
+    if constexpr (std::is_same_v<T, float>) return Float32;
+    else if constexpr (std::is_same_v<T, double>) return Float64;
+    else if constexpr (std::is_same_v<T, numeric::half>) return Float16;
+    else if constexpr (std::is_same_v<T, numeric::bfloat16>) return BFloat16;
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return sizeof(T) == 1 ? Int8 : sizeof(T) == 2 ? Int16 : sizeof(T) == 4 ? Int32 : Int64;
+    } else if constexpr (std::is_integral_v<T>) {
+        return sizeof(T) == 1 ? Uint8 : sizeof(T) == 2 ? Uint16 : sizeof(T) == 4 ? Uint32 : Uint64;
+    } else {
+        return Unknown;
+    }
+}
+
+// Способ загрузки двоичного файла: скопировать данные в буфер вектора
+// или использовать отображенные в память страницы файла как буфер
+enum class ImportMode { Copy, Adopt };
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;      // endianMarker в порядке байт записавшей машины
+    uint32_t typeTag;
+    uint32_t elementSize;
+    uint64_t count;
+    uint64_t checksum;    // checksum64 по байтам данных файла
+    uint8_t reserved[24];
+};
+static_assert(sizeof(BinaryHeader) == 64, "Заголовок должен занимать 64 байта");
+
+inline uint64_t byteSwap(uint64_t v) { return __builtin_bswap64(v); }
+inline uint32_t byteSwap(uint32_t v) { return __builtin_bswap32(v); }
+
+// Перестановка байт элемента при чтении файла с другим порядком байт
+template<typename T>
+T byteSwapValue(T value) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+        std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+// 8-байтное слово, прочитанное как little-endian, на машине любого порядка байт
+inline uint64_t fromLittleEndian(uint64_t w) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return byteSwap(w);
+#else
+    return w;
+#endif
+}
+
+// Контрольная сумма: сумма перемешанных 8-байтных слов с учетом их номера.
+// Сложение коммутативно, поэтому части файла можно считать параллельно,
+// а номер слова делает сумму чувствительной к перестановкам. Слова читаются
+// как little-endian, поэтому сумма зависит только от байт файла, а не от
+// порядка байт машины: файл, записанный на машине с другим порядком, проходит
+// проверку до перестановки элементов.
+// firstWord - номер первого слова участка, участок начинается на границе слова.
+inline uint64_t checksum64(const void* bytes, size_t length, uint64_t firstWord) {
+    auto mix = [](uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    };
+    const unsigned char* p = static_cast<const unsigned char*>(bytes);
+    uint64_t sum = 0;
+    size_t words = length / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t w;
+        std::memcpy(&w, p + i * 8, 8);
+        sum += mix(fromLittleEndian(w) + (firstWord + i) * 0x9E3779B97F4A7C15ULL);
+    }
+    size_t rest = length % 8;
+    if (rest > 0) {
+        uint64_t w = 0;
+        std::memcpy(&w, p + words * 8, rest);
+        sum += mix(fromLittleEndian(w) + (firstWord + words) * 0x9E3779B97F4A7C15ULL);
+    }
+    return sum;
+}
+
+// checksum64 длинного участка, посчитанная частями в пуле потоков
+inline uint64_t checksumParallel(const void* bytes, size_t length, size_t numTasks) {
+    const char* p = static_cast<const char*>(bytes);
+    size_t words = (length + 7) / 8;
+    size_t wordsPerTask = (words + numTasks - 1) / numTasks;
+    PaddedSlots<uint64_t> partial(numTasks, 0);
+    ThreadPool::instance().run(numTasks, [&](size_t task) {
+        size_t firstWord = task * wordsPerTask;
+        size_t from = std::min(length, firstWord * 8);
+        size_t to = std::min(length, (firstWord + wordsPerTask) * 8);
+        partial[task] = checksum64(p + from, to - from, firstWord);
+    });
+    uint64_t sum = 0;
+    partial.forEach([&](uint64_t part) {
+        sum += part;
+    });
+    return sum;
+}
+
+// Файл, отображенный в память с копированием при записи (MAP_PRIVATE):
+// изменения страниц остаются в процессе и в файл не попадают
+class MappedFile {
+private:
+    void* address = nullptr;
+    size_t length = 0;
+
+    void unmap() {
+        if (address) {
+            munmap(address, length);
+            address = nullptr;
+            length = 0;
+        }
+    }
+
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::ios_base::failure("Не удается открыть файл " + filename);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("Пустой или недоступный файл " + filename);
+        }
+        length = static_cast<size_t>(info.st_size);
+        address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            address = nullptr;
+            throw std::runtime_error("Не удалось отобразить файл в память");
+        }
+        // Данные читаются последовательно: просим ядро читать наперед
+        madvise(address, length, MADV_SEQUENTIAL);
+    }
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept : address(other.address), length(other.length) {
+        other.address = nullptr;
+        other.length = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            address = other.address;
+            length = other.length;
+            other.address = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+
+    bool isMapped() const { return address != nullptr; }
+    char* bytes() const { return static_cast<char*>(address); }
+    size_t size() const { return length; }
+};
+
+// Проверка заголовка; возвращает true, если порядок байт файла отличается
+// от порядка байт этой машины
+template<typename T>
+bool validateHeader(const BinaryHeader& header, size_t fileSize) {
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Файл не является двоичным файлом вектора");
+    }
+    bool swapped = header.endian != endianMarker;
+    if (swapped && byteSwap(header.endian) != endianMarker) {
+        throw std::runtime_error("Поврежденный заголовок файла");
+    }
+    uint32_t version = swapped ? byteSwap(header.version) : header.version;
+    uint32_t tag = swapped ? byteSwap(header.typeTag) : header.typeTag;
+    uint32_t elementSize = swapped ? byteSwap(header.elementSize) : header.elementSize;
+    uint64_t count = swapped ? byteSwap(header.count) : header.count;
+    if (version != currentVersion) {
+        throw std::runtime_error("Неподдерживаемая версия формата");
+    }
+    if (tag != typeTag<T>() || elementSize != sizeof(T)) {
+        throw std::runtime_error("Тип элементов файла не совпадает с типом вектора");
+    }
+    // Сравнение делением: count * sizeof(T) из поврежденного заголовка
+    // может переполниться и пройти проверку суммой
+    if (fileSize < sizeof(BinaryHeader) || count > (fileSize - sizeof(BinaryHeader)) / sizeof(T)) {
+        throw std::runtime_error("Файл короче, чем указано в заголовке");
+    }
+    return swapped;
+}
+
+} // namespace binary
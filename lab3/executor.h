@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Исполнитель асинхронных этапов (импорт, свертки, экспорт) с очередью
+// заданий и std::future в качестве результата. Это не ThreadPool: этап
+// большую часть времени ждет диск или сам раздает части в ThreadPool, поэтому
+// этапы выполняются отдельными потоками, а параллельные части - общим пулом.
+//
+// Этап, который ждет результат другого этапа, должен ждать через await/then:
+// пока результат не готов, ожидающий поток выполняет задания из очереди,
+// поэтому цепочки зависимых этапов не блокируют все потоки исполнителя.
+class Executor {
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::function<void()>> queue;
+    bool stopping = false;
+
+    // Забирает задание из очереди; false, если очередь пуста
+    bool tryPop(std::function<void()>& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) {
+            return false;
+        }
+        task = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&] { return stopping || !queue.empty(); });
+                // При остановке очередь дорабатывается до конца
+                if (queue.empty()) {
+                    return;
+                }
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    void push(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(task));
+        }
+        ready.notify_one();
+    }
+
+public:
+    explicit Executor(size_t numThreads) {
+        numThreads = std::max<size_t>(1, numThreads);
+        threads.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) {
+            threads.emplace_back(&Executor::workerLoop, this);
+        }
+    }
+
+    ~Executor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    size_t size() const {
+        return threads.size();
+    }
+
+    // Ставит fn() в очередь; исключение fn передается через future
+    template<typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& fn) {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> result = task->get_future();
+        push([task] { (*task)(); });
+        return result;
+    }
+
+    // Ждет future, выполняя тем временем задания из очереди. Если очередь
+    // пуста, ожидаемое задание уже выполняется другим потоком, и можно
+    // просто ждать его.
+    template<typename Future>
+    void wait(const Future& future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            std::function<void()> task;
+            if (!tryPop(task)) {
+                future.wait();
+                return;
+            }
+            task();
+        }
+    }
+
+    template<typename R>
+    R await(std::future<R>& future) {
+        wait(future);
+        return future.get();
+    }
+
+    template<typename R>
+    decltype(auto) await(const std::shared_future<R>& future) {
+        wait(future);
+        return future.get();
+    }
+
+    // Следующий этап цепочки: fn(результат source), или fn() для source без
+    // результата. Исключение source передается в future следующего этапа.
+    template<typename R, typename F>
+    auto then(std::shared_future<R> source, F&& fn) {
+        return submit([this, source = std::move(source), fn = std::forward<F>(fn)]() mutable {
+            if constexpr (std::is_void_v<R>) {
+                await(source);
+                return fn();
+            } else {
+                return fn(await(source));
+            }
+        });
+    }
+
+    // Общий исполнитель процесса: этапов одновременно немного (загрузка,
+    // обработка, выгрузка), поэтому потоков меньше, чем в ThreadPool
+    static Executor& instance() {
+        static Executor executor(std::max<size_t>(4, std::thread::hardware_concurrency() / 4));
+        return executor;
+    }
+};
@@ -0,0 +1,417 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "numeric.h"
+#include "paddedSlots.h"
+#include "scheduler.h"
+#include "simd.h"
+#include "vectorView.h"
+
+// Ленивые поэлементные выражения над Vector и VectorView (expression
+// templates). Запись (a - b) * w или abs(a - m) ничего не вычисляет, а
+// строит дерево узлов, которое знает свой размер и значение i-го элемента.
+// Вычисляет выражение потребитель: свертка (expr::sum, expr::findMax, ...)
+// или присваивание в Vector. Он делит индексы на части по расписанию, и
+// каждая часть вычисляет выражение блоками по blockSize элементов в буфер на
+// стеке, который лежит в L1, и сразу сворачивает блок векторными ядрами
+// simd. Промежуточные векторы не создаются, и каждый операнд читается из
+// памяти один раз, сколько бы операций ни было в выражении.
+//
+// Операнд Vector закрепляет снимок своих данных (Vector::snapshot), поэтому
+// выражение можно сохранить в переменной, а запись в вектор после его
+// построения не меняет результат. VectorView хранится по значению и должен
+// оставаться действительным до вычисления. Скаляр приводится к типу
+// элементов другого операнда, если тот с плавающей точкой: a * 2.0 для
+// Vector<float> считается во float. С целым операндом скаляр берется в общем
+// типе: a * 0.5 для Vector<int> считается в double, а не умножает на 0.
+// half и bfloat16 в выражениях считаются во float.
+//
+// Операторы объявлены в глобальном пространстве имен, как Vector и
+// VectorView, и участвуют в перегрузке, только если хотя бы один операнд -
+// вектор, представление или выражение. Функции abs, sqrt, min, max для
+// выражений находятся по аргументам, а для самого вектора пишутся с
+// пространством имен: expr::abs(a).
+namespace expr {
+
+// Сколько элементов выражения вычисляется за раз в буфер на стеке
+constexpr size_t blockSize = 512;
+
+// Размер скаляра: подходит к выражению любого размера
+constexpr size_t anySize = std::numeric_limits<size_t>::max();
+
+// Тип, в котором считаются элементы T
+template<typename T>
+using ArithmeticType = std::conditional_t<numeric::isReducedFloat<T>, float, T>;
+
+// Базовый класс узлов выражения
+struct Node {};
+
+template<typename E>
+constexpr bool isNode = std::is_base_of_v<Node, E>;
+
+// Лист из подряд идущих элементов. Keeper продлевает жизнь данных
+// (снимок вектора) и не используется при вычислении.
+template<typename T, typename Keeper>
+class Terminal : public Node {
+private:
+    Keeper keeper;
+    const T* data;
+    size_t length;
+
+public:
+    using value_type = ArithmeticType<T>;
+
+    Terminal(Keeper keeper, const T* data, size_t size) : keeper(std::move(keeper)), data(data), length(size) {}
+
+    size_t size() const { return length; }
+    value_type operator[](size_t i) const { return static_cast<value_type>(data[i]); }
+};
+
+// Лист из элементов с шагом (VectorView); данными не владеет
+template<typename T>
+class StridedTerminal : public Node {
+private:
+    const T* data;
+    size_t length;
+    size_t step;
+
+public:
+    using value_type = ArithmeticType<T>;
+
+    explicit StridedTerminal(const VectorView<T>& view) : data(view.data()), length(view.size()), step(view.stride()) {}
+
+    size_t size() const { return length; }
+    value_type operator[](size_t i) const { return static_cast<value_type>(data[i * step]); }
+};
+
+template<typename T>
+class Scalar : public Node {
+private:
+    T value;
+
+public:
+    using value_type = T;
+
+    explicit Scalar(T value) : value(value) {}
+
+    size_t size() const { return anySize; }
+    value_type operator[](size_t) const { return value; }
+};
+
+template<typename Op, typename E>
+class Unary : public Node {
+private:
+    E operand;
+
+public:
+    using value_type = decltype(Op()(std::declval<typename E::value_type>()));
+
+    explicit Unary(E operand) : operand(std::move(operand)) {}
+
+    size_t size() const { return operand.size(); }
+    value_type operator[](size_t i) const { return Op()(operand[i]); }
+};
+
+template<typename Op, typename L, typename R>
+class Binary : public Node {
+private:
+    L left;
+    R right;
+
+public:
+    using value_type = decltype(Op()(std::declval<typename L::value_type>(), std::declval<typename R::value_type>()));
+
+    Binary(L left, R right) : left(std::move(left)), right(std::move(right)) {
+        if (this->left.size() != anySize && this->right.size() != anySize && this->left.size() != this->right.size()) {
+            throw std::invalid_argument("Размеры векторов не совпадают");
+        }
+    }
+
+    size_t size() const { return left.size() != anySize ? left.size() : right.size(); }
+    value_type operator[](size_t i) const { return Op()(left[i], right[i]); }
+};
+
+// Поэлементные операции
+struct Plus {
+    template<typename A, typename B>
+    auto operator()(A a, B b) const { return a + b; }
+};
+
+struct Minus {
+    template<typename A, typename B>
+    auto operator()(A a, B b) const { return a - b; }
+};
+
+struct Multiplies {
+    template<typename A, typename B>
+    auto operator()(A a, B b) const { return a * b; }
+};
+
+struct Divides {
+    template<typename A, typename B>
+    auto operator()(A a, B b) const { return a / b; }
+};
+
+struct Negate {
+    template<typename A>
+    auto operator()(A a) const { return -a; }
+};
+
+struct Abs {
+    template<typename A>
+    A operator()(A a) const {
+        if constexpr (std::is_unsigned_v<A>) {
+            return a;
+        } else {
+            return a < A(0) ? -a : a;
+        }
+    }
+};
+
+struct Sqrt {
+    template<typename A>
+    auto operator()(A a) const { return std::sqrt(a); }
+};
+
+struct Min {
+    template<typename A, typename B>
+    auto operator()(A a, B b) const {
+        using C = std::common_type_t<A, B>;
+        return static_cast<C>(b) < static_cast<C>(a) ? static_cast<C>(b) : static_cast<C>(a);
+    }
+};
+
+struct Max {
+    template<typename A, typename B>
+    auto operator()(A a, B b) const {
+        using C = std::common_type_t<A, B>;
+        return static_cast<C>(b) > static_cast<C>(a) ? static_cast<C>(b) : static_cast<C>(a);
+    }
+};
+
+// Что может быть операндом выражения: узлы, VectorView и (в vector.h) Vector.
+// wrap превращает операнд в узел.
+template<typename X, typename = void>
+struct OperandTraits {
+    static constexpr bool isOperand = false;
+};
+
+template<typename X>
+struct OperandTraits<X, std::enable_if_t<isNode<X>>> {
+    static constexpr bool isOperand = true;
+    static const X& wrap(const X& node) { return node; }
+};
+
+template<typename T>
+struct OperandTraits<VectorView<T>> {
+    static constexpr bool isOperand = true;
+    static StridedTerminal<T> wrap(const VectorView<T>& view) { return StridedTerminal<T>(view); }
+};
+
+template<typename X>
+constexpr bool isOperand = OperandTraits<std::decay_t<X>>::isOperand;
+
+template<typename X>
+constexpr bool isScalar = std::is_arithmetic_v<std::decay_t<X>> || numeric::isReducedFloat<std::decay_t<X>>;
+
+template<typename X>
+auto operand(const X& x) {
+    return OperandTraits<X>::wrap(x);
+}
+
+template<typename X>
+using OperandNode = std::decay_t<decltype(operand(std::declval<const X&>()))>;
+
+// Хотя бы один из операндов - выражение, второй - выражение или скаляр
+template<typename L, typename R>
+constexpr bool isBinaryOperands = (isOperand<L> && (isOperand<R> || isScalar<R>)) || (isScalar<L> && isOperand<R>);
+
+// Тип узла скаляра S рядом с операндом из элементов E: тип операнда, если он
+// с плавающей точкой, иначе общий тип, чтобы дробный скаляр не обрезался
+template<typename E, typename S>
+using ScalarType = std::conditional_t<std::is_floating_point_v<E>, E, std::common_type_t<E, ArithmeticType<S>>>;
+
+template<typename Op, typename L, typename R>
+auto makeBinary(const L& left, const R& right) {
+    if constexpr (isScalar<L>) {
+        using V = ScalarType<typename OperandNode<R>::value_type, L>;
+        return Binary<Op, Scalar<V>, OperandNode<R>>(Scalar<V>(static_cast<V>(left)), operand(right));
+    } else if constexpr (isScalar<R>) {
+        using V = ScalarType<typename OperandNode<L>::value_type, R>;
+        return Binary<Op, OperandNode<L>, Scalar<V>>(operand(left), Scalar<V>(static_cast<V>(right)));
+    } else {
+        return Binary<Op, OperandNode<L>, OperandNode<R>>(operand(left), operand(right));
+    }
+}
+
+template<typename X, typename = std::enable_if_t<isOperand<X>>>
+auto abs(const X& x) {
+    return Unary<Abs, OperandNode<X>>(operand(x));
+}
+
+template<typename X, typename = std::enable_if_t<isOperand<X>>>
+auto sqrt(const X& x) {
+    return Unary<Sqrt, OperandNode<X>>(operand(x));
+}
+
+// Поэлементные минимум и максимум
+template<typename L, typename R, typename = std::enable_if_t<isBinaryOperands<L, R>>>
+auto min(const L& left, const R& right) {
+    return makeBinary<Min>(left, right);
+}
+
+template<typename L, typename R, typename = std::enable_if_t<isBinaryOperands<L, R>>>
+auto max(const L& left, const R& right) {
+    return makeBinary<Max>(left, right);
+}
+
+// Обобщенная свертка выражения, как VectorView::parallelReduce: для каждого
+// вычисленного блока вызывается mapFn(блок, длина, индекс начала) -> R,
+// результаты сворачиваются combineFn по порядку, начиная с init
+template<typename X, typename R, typename MapFn, typename CombineFn>
+R reduce(const X& x, R init, MapFn&& mapFn, CombineFn&& combineFn, ReduceOptions options = {}) {
+    auto node = operand(x);
+    using V = typename decltype(node)::value_type;
+    size_t length = node.size();
+    if (length == 0) {
+        return init;
+    }
+
+    auto reduceChunk = [&](size_t start, size_t end) {
+        R result = init;
+        V block[blockSize];
+        for (size_t from = start; from < end; from += blockSize) {
+            size_t blockLen = std::min(blockSize, end - from);
+            if (blockLen == blockSize) {
+                // Постоянная длина цикла позволяет компилятору векторизовать его
+                for (size_t i = 0; i < blockSize; ++i) {
+                    block[i] = node[from + i];
+                }
+            } else {
+                for (size_t i = 0; i < blockLen; ++i) {
+                    block[i] = node[from + i];
+                }
+            }
+            result = combineFn(result, mapFn(static_cast<const V*>(block), blockLen, from));
+        }
+        return result;
+    };
+
+    auto bounds = scheduler::partition(0, length, options.numThreads, options.schedule, options.grain);
+    PaddedSlots<R> partial(bounds.size() - 1, init);
+    scheduler::run(bounds.size() - 1, options.numThreads, options.schedule, [&](size_t chunk) {
+        if (bounds[chunk] < bounds[chunk + 1]) {
+            partial[chunk] = reduceChunk(bounds[chunk], bounds[chunk + 1]);
+        }
+    });
+
+    R result = init;
+    partial.forEach([&](const R& part) {
+        result = combineFn(result, part);
+    });
+    return result;
+}
+
+template<typename X>
+using ValueType = typename OperandNode<X>::value_type;
+
+template<typename X, typename = std::enable_if_t<isOperand<X>>>
+numeric::Accumulator<ValueType<X>> sum(const X& x, ReduceOptions options = {}) {
+    using V = ValueType<X>;
+    using S = numeric::Accumulator<V>;
+    return reduce(
+        x, S(0), [](const V* block, size_t blockLen, size_t) { return simd::sum(block, blockLen); }, std::plus<S>(),
+        options);
+}
+
+template<typename X, typename = std::enable_if_t<isOperand<X>>>
+double mean(const X& x, ReduceOptions options = {}) {
+    size_t length = operand(x).size();
+    if (length == 0) {
+        throw std::logic_error("Выражение пустое");
+    }
+    return static_cast<double>(sum(x, options)) / static_cast<double>(length);
+}
+
+// Минимум выражения и индекс его первого вхождения. Свертка начинается с
+// элемента 0, поэтому результат - всегда элемент выражения
+template<typename X, typename = std::enable_if_t<isOperand<X>>>
+std::pair<ValueType<X>, size_t> findMin(const X& x, ReduceOptions options = {}) {
+    using V = ValueType<X>;
+    auto node = operand(x);
+    if (node.size() == 0) {
+        throw std::logic_error("Выражение пустое");
+    }
+    return reduce(
+        node, std::pair<V, size_t>(node[0], 0),
+        [](const V* block, size_t blockLen, size_t offset) {
+            auto [value, index] = simd::argMin(block, blockLen);
+            return std::pair<V, size_t>(value, offset + index);
+        },
+        [](const std::pair<V, size_t>& a, const std::pair<V, size_t>& b) { return b.first < a.first ? b : a; },
+        options);
+}
+
+template<typename X, typename = std::enable_if_t<isOperand<X>>>
+std::pair<ValueType<X>, size_t> findMax(const X& x, ReduceOptions options = {}) {
+    using V = ValueType<X>;
+    auto node = operand(x);
+    if (node.size() == 0) {
+        throw std::logic_error("Выражение пустое");
+    }
+    return reduce(
+        node, std::pair<V, size_t>(node[0], 0),
+        [](const V* block, size_t blockLen, size_t offset) {
+            auto [value, index] = simd::argMax(block, blockLen);
+            return std::pair<V, size_t>(value, offset + index);
+        },
+        [](const std::pair<V, size_t>& a, const std::pair<V, size_t>& b) { return b.first > a.first ? b : a; },
+        options);
+}
+
+// Вычисляет выражение в out[0, size) за один параллельный проход
+template<typename T, typename X>
+void evaluateInto(const X& x, T* out, ReduceOptions options = {}) {
+    auto node = operand(x);
+    auto bounds = scheduler::partition(0, node.size(), options.numThreads, options.schedule, options.grain);
+    scheduler::run(bounds.size() - 1, options.numThreads, options.schedule, [&](size_t chunk) {
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            out[i] = static_cast<T>(node[i]);
+        }
+    });
+}
+
+} // namespace expr
+
+template<typename L, typename R, typename = std::enable_if_t<expr::isBinaryOperands<L, R>>>
+auto operator+(const L& left, const R& right) {
+    return expr::makeBinary<expr::Plus>(left, right);
+}
+
+template<typename L, typename R, typename = std::enable_if_t<expr::isBinaryOperands<L, R>>>
+auto operator-(const L& left, const R& right) {
+    return expr::makeBinary<expr::Minus>(left, right);
+}
+
+template<typename L, typename R, typename = std::enable_if_t<expr::isBinaryOperands<L, R>>>
+auto operator*(const L& left, const R& right) {
+    return expr::makeBinary<expr::Multiplies>(left, right);
+}
+
+template<typename L, typename R, typename = std::enable_if_t<expr::isBinaryOperands<L, R>>>
+auto operator/(const L& left, const R& right) {
+    return expr::makeBinary<expr::Divides>(left, right);
+}
+
+template<typename X, typename = std::enable_if_t<expr::isOperand<X>>>
+auto operator-(const X& x) {
+    return expr::Unary<expr::Negate, expr::OperandNode<X>>(expr::operand(x));
+}
@@ -0,0 +1,104 @@
+// Микробенчмарк ложного разделения строк кэша: накопление суммы прямо в
+// общий std::vector (allSum[threadId] += data[i], как было в лабораторной)
+// против накопления в регистре и одной записи в PaddedSlots.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread falseSharing.cpp -o falseSharing.out
+// Запуск: ./falseSharing.out [размер] [проходов] [максимум потоков]
+
+#include "paddedSlots.h"
+#include "perfCounters.h"
+#include "threadPool.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+struct Measurement {
+    double seconds = 0;
+    PerfCounters::Event events[3] = {PerfCounters::Cycles, PerfCounters::CacheMisses, PerfCounters::L1DMisses};
+    std::string counters[3];
+};
+
+// Запускает kernel(threadId, start, end) на numThreads потоках, passes раз.
+// Пул создается после открытия счетчиков, чтобы они учли рабочие потоки.
+template<typename Kernel>
+Measurement measure(size_t numThreads, size_t n, size_t passes, Kernel&& kernel) {
+    Measurement result;
+    PerfCounters counters;
+    counters.start();
+    {
+        ThreadPool pool(numThreads);
+        size_t chunkSize = n / numThreads;
+        auto startTime = std::chrono::steady_clock::now();
+        for (size_t pass = 0; pass < passes; ++pass) {
+            pool.run(numThreads, [&](size_t i) {
+                size_t start = i * chunkSize;
+                size_t end = (i == numThreads - 1) ? n : (i + 1) * chunkSize;
+                kernel(i, start, end);
+            });
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        result.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    }
+    counters.stop();
+    for (int k = 0; k < 3; ++k) {
+        result.counters[k] = counters.format(result.events[k]);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    size_t passes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+    size_t maxThreads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 64;
+
+    std::vector<double> data(n, 1.0);
+    const double* values = data.data();
+    volatile double sink = 0;
+
+    std::cout << "вариант\tпотоки\tвремя, мс\tускорение";
+    for (auto event : Measurement().events) {
+        std::cout << "\t" << PerfCounters::name(event);
+    }
+    std::cout << "\n";
+
+    double sharedBase = 0, paddedBase = 0;
+    for (size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        // Общий вектор: соседние потоки пишут в одну строку кэша на каждом элементе
+        std::vector<double> allSum(numThreads);
+        Measurement shared = measure(numThreads, n, passes, [&](size_t threadId, size_t start, size_t end) {
+            allSum[threadId] = 0;
+            for (size_t i = start; i < end; ++i) {
+                allSum[threadId] += values[i];
+            }
+        });
+        sink = sink + allSum[0];
+
+        // Локальный аккумулятор и одна запись в отдельную строку кэша
+        PaddedSlots<double> slots(numThreads, 0.0);
+        Measurement padded = measure(numThreads, n, passes, [&](size_t threadId, size_t start, size_t end) {
+            double sum = 0;
+            for (size_t i = start; i < end; ++i) {
+                sum += values[i];
+            }
+            slots[threadId] = sum;
+        });
+        sink = sink + slots[0];
+
+        if (numThreads == 1) {
+            sharedBase = shared.seconds;
+            paddedBase = padded.seconds;
+        }
+        for (auto [name, m, base] : {std::make_tuple("shared", &shared, sharedBase),
+                                     std::make_tuple("padded", &padded, paddedBase)}) {
+            std::cout << name << "\t" << numThreads << "\t" << m->seconds * 1000 << "\t" << base / m->seconds;
+            for (const auto& counter : m->counters) {
+                std::cout << "\t" << counter;
+            }
+            std::cout << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Поэлементная арифметика со свертками (expression.h): sum((a - b) * w) и
+// max(abs(a - mean)) сначала через промежуточные массивы, по проходу памяти
+// на каждую операцию, затем одним выражением, которое вычисляется за один
+// проход (в одном потоке и в пуле).
+//
+// Сборка: g++ -std=c++17 -O2 -pthread fused.cpp -o fused.out
+// Запуск: ./fused.out [размер] [повторы]
+
+#include "vector.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Лучшее время из repetitions запусков fn
+template<typename Fn>
+static double bestOf(size_t repetitions, Fn&& fn) {
+    double best = 0;
+    for (size_t r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double seconds = secondsSince(start);
+        best = r == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 24;
+    size_t repetitions = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+
+    try {
+        size_t numThreads = ThreadPool::instance().size();
+        Vector<double> a(n), b(n), w(n), result(n);
+        a.initializeRandom(0.0, 1.0, 1, numThreads);
+        b.initializeRandom(0.0, 1.0, 2, numThreads);
+        w.initializeRandom(0.0, 1.0, 3, numThreads);
+        auto aData = a.snapshot(), bData = b.snapshot(), wData = w.snapshot();
+        const double* x = aData.data();
+        const double* y = bData.data();
+        const double* z = wData.data();
+        std::vector<double> difference(n), product(n);
+
+        // Промежуточные векторы: a - b, затем * w, затем сумма - три прохода
+        double weighted = 0;
+        double separate = bestOf(repetitions, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                difference[i] = x[i] - y[i];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                product[i] = difference[i] * z[i];
+            }
+            weighted = simd::sum(product.data(), n);
+        });
+        double fusedWeighted = 0;
+        double fused = bestOf(repetitions, [&] { fusedWeighted = expr::sum((a - b) * w, {1}); });
+        double fusedParallel = bestOf(repetitions, [&] { fusedWeighted = expr::sum((a - b) * w, {numThreads}); });
+        std::cout << "sum((a - b) * w) = " << weighted << ": по операциям " << separate * 1000 << " мс, выражением "
+                  << fused * 1000 << " мс (ускорение " << separate / fused << "), выражением в " << numThreads
+                  << " потоках " << fusedParallel * 1000 << " мс, результат " << fusedWeighted << "\n";
+
+        double mean = a.calculateMeanParallel(numThreads);
+        std::pair<double, size_t> deviation;
+        separate = bestOf(repetitions, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                difference[i] = x[i] - mean;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                product[i] = std::abs(difference[i]);
+            }
+            deviation = simd::argMax(product.data(), n);
+        });
+        std::pair<double, size_t> fusedDeviation;
+        fused = bestOf(repetitions, [&] { fusedDeviation = expr::findMax(abs(a - mean), {1}); });
+        std::cout << "max(abs(a - mean)) = " << deviation.first << " [" << deviation.second << "]: по операциям "
+                  << separate * 1000 << " мс, выражением " << fused * 1000 << " мс (ускорение " << separate / fused
+                  << "), результат " << fusedDeviation.first << " [" << fusedDeviation.second << "]\n";
+
+        // Присваивание выражения: один проход записи в новый буфер вектора
+        double assigned = bestOf(repetitions, [&] { result = (a - b) * w + 1.0; });
+        std::cout << "result = (a - b) * w + 1: " << assigned * 1000 << " мс, сумма "
+                  << result.calculateSumParallel(numThreads) << "\n";
+
+        // Дробный скаляр с целым вектором считается в общем типе, а не обрезается до 0
+        Vector<int> counts(1000);
+        counts.initializeRandom(1, 100, 3, 1);
+        double halfSum = static_cast<double>(expr::sum(counts * 0.5));
+        std::cout << "sum(counts * 0.5) = " << halfSum << ", sum(counts) / 2 = "
+                  << static_cast<double>(counts.calculateSumParallel(1)) / 2
+                  << (halfSum != 0 ? "" : " (скаляр обрезан до 0)") << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Типы хранения пониженной точности и типы аккумуляторов для сверток.
+//
+// half и bfloat16 хранят 16 бит и приводятся к float неявно, поэтому
+// сравнения и арифметика идут в float, а обратное преобразование из float
+// явное (с округлением к ближайшему четному). Такой вектор занимает вдвое
+// меньше памяти, чем Vector<float>, а свертки читают вдвое меньше байт.
+namespace numeric {
+
+inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float floatFromBits(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// IEEE 754 binary16: 5 бит порядка и 10 бит мантиссы, до 65504 по модулю
+struct half {
+    uint16_t bits;
+
+    half() = default;
+
+    explicit half(float value) : bits(fromFloat(value)) {}
+
+    operator float() const {
+        // Сдвиг порядка и мантиссы на место float; субнормальные числа
+        // нормализуются вычитанием 2^-14
+        constexpr uint32_t shiftedExponent = 0x7c00u << 13;
+        uint32_t result = (bits & 0x7fffu) << 13;
+        uint32_t exponent = result & shiftedExponent;
+        result += (127 - 15) << 23;
+        if (exponent == shiftedExponent) {
+            result += (128 - 16) << 23;
+        } else if (exponent == 0) {
+            result += 1 << 23;
+            result = floatBits(floatFromBits(result) - floatFromBits(113u << 23));
+        }
+        return floatFromBits(result | (static_cast<uint32_t>(bits & 0x8000u) << 16));
+    }
+
+    static constexpr half fromRaw(uint16_t raw) {
+        half value{};
+        value.bits = raw;
+        return value;
+    }
+
+private:
+    static uint16_t fromFloat(float value) {
+        uint32_t x = floatBits(value);
+        uint32_t sign = x & 0x80000000u;
+        x ^= sign;
+        uint32_t result;
+        if (x >= (127u + 16) << 23) {
+            // Переполнение дает бесконечность, NaN остается NaN
+            result = x > 0x7f800000u ? 0x7e00u : 0x7c00u;
+        } else if (x < 113u << 23) {
+            // Субнормальное half: сложение с 0.5f округляет мантиссу аппаратно
+            constexpr uint32_t magic = 126u << 23;
+            result = floatBits(floatFromBits(x) + floatFromBits(magic)) - magic;
+        } else {
+            uint32_t mantissaOdd = (x >> 13) & 1;
+            x += ((15u - 127u) << 23) + 0xfffu + mantissaOdd;
+            result = x >> 13;
+        }
+        return static_cast<uint16_t>(result | (sign >> 16));
+    }
+};
+
+// bfloat16: старшие 16 бит float (8 бит порядка, 7 бит мантиссы). Диапазон
+// как у float, точность около трех десятичных знаков.
+struct bfloat16 {
+    uint16_t bits;
+
+    bfloat16() = default;
+
+    explicit bfloat16(float value) : bits(fromFloat(value)) {}
+
+    operator float() const {
+        return floatFromBits(static_cast<uint32_t>(bits) << 16);
+    }
+
+    static constexpr bfloat16 fromRaw(uint16_t raw) {
+        bfloat16 value{};
+        value.bits = raw;
+        return value;
+    }
+
+private:
+    static uint16_t fromFloat(float value) {
+        uint32_t x = floatBits(value);
+        if ((x & 0x7fffffffu) > 0x7f800000u) {
+            return static_cast<uint16_t>((x >> 16) | 0x40u);
+        }
+        x += 0x7fffu + ((x >> 16) & 1);
+        return static_cast<uint16_t>(x >> 16);
+    }
+};
+
+template<typename T>
+constexpr bool isReducedFloat = std::is_same_v<T, half> || std::is_same_v<T, bfloat16>;
+
+// Вещественный тип, включая типы пониженной точности
+template<typename T>
+constexpr bool isFloating = std::is_floating_point_v<T> || isReducedFloat<T>;
+
+// Тип, в котором копится сумма элементов T: целые расширяются до 64 бит,
+// float и 16-битные форматы - до double, чтобы сумма десятков миллионов
+// элементов не переполнялась и не теряла младшие разряды. Специализацию
+// можно добавить для своего типа.
+template<typename T>
+struct AccumulatorTraits {
+    using type = std::conditional_t<std::is_integral_v<T>,
+        std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>,
+        std::conditional_t<std::is_same_v<T, long double>, long double, double>>;
+};
+
+template<typename T>
+using Accumulator = typename AccumulatorTraits<T>::type;
+
+} // namespace numeric
+
+namespace std {
+
+template<>
+class numeric_limits<numeric::half> {
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = 11;
+    static constexpr int max_exponent = 16;
+    static constexpr int min_exponent = -13;
+
+    static constexpr numeric::half min() { return numeric::half::fromRaw(0x0400); }
+    static constexpr numeric::half max() { return numeric::half::fromRaw(0x7bff); }
+    static constexpr numeric::half lowest() { return numeric::half::fromRaw(0xfbff); }
+    static constexpr numeric::half epsilon() { return numeric::half::fromRaw(0x1400); }
+    static constexpr numeric::half infinity() { return numeric::half::fromRaw(0x7c00); }
+    static constexpr numeric::half quiet_NaN() { return numeric::half::fromRaw(0x7e00); }
+};
+
+template<>
+class numeric_limits<numeric::bfloat16> {
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = 8;
+    static constexpr int max_exponent = 128;
+    static constexpr int min_exponent = -125;
+
+    static constexpr numeric::bfloat16 min() { return numeric::bfloat16::fromRaw(0x0080); }
+    static constexpr numeric::bfloat16 max() { return numeric::bfloat16::fromRaw(0x7f7f); }
+    static constexpr numeric::bfloat16 lowest() { return numeric::bfloat16::fromRaw(0xff7f); }
+    static constexpr numeric::bfloat16 epsilon() { return numeric::bfloat16::fromRaw(0x3c00); }
+    static constexpr numeric::bfloat16 infinity() { return numeric::bfloat16::fromRaw(0x7f80); }
+    static constexpr numeric::bfloat16 quiet_NaN() { return numeric::bfloat16::fromRaw(0x7fc0); }
+};
+
+} // namespace std
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+
+// Части порядковых статистик, которые выполняются внутри одной части
+// вектора; разбиение на части и объединение результатов делает Vector.
+// Значения NaN не упорядочены, поэтому для них результат не определен.
+namespace order {
+
+// Значение с индексом в векторе
+template<typename T>
+using Ranked = std::pair<T, size_t>;
+
+// Порядок для top-k: сначала лучшие значения, при равенстве - меньший индекс
+template<typename T, bool Largest>
+bool better(const Ranked<T>& a, const Ranked<T>& b) {
+    if (a.first != b.first) {
+        return Largest ? a.first > b.first : a.first < b.first;
+    }
+    return a.second < b.second;
+}
+
+// k лучших элементов участка [offset, offset + len) в порядке better.
+// Куча из k элементов: худший из отобранных на вершине и вытесняется,
+// если очередной элемент лучше него.
+template<typename T, bool Largest>
+std::vector<Ranked<T>> topKRange(const T* data, size_t len, size_t offset, size_t k) {
+    std::vector<Ranked<T>> heap;
+    heap.reserve(std::min(k, len));
+    auto cmp = better<T, Largest>;
+    for (size_t i = 0; i < len; ++i) {
+        Ranked<T> item(data[i], offset + i);
+        if (heap.size() < k) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        } else if (cmp(item, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            heap.back() = item;
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), cmp);
+    return heap;
+}
+
+// Слияние двух упорядоченных списков с сохранением k лучших
+template<typename T, bool Largest>
+std::vector<Ranked<T>> mergeTopK(const std::vector<Ranked<T>>& a, const std::vector<Ranked<T>>& b, size_t k) {
+    std::vector<Ranked<T>> merged;
+    merged.reserve(std::min(k, a.size() + b.size()));
+    size_t i = 0, j = 0;
+    while (merged.size() < k && (i < a.size() || j < b.size())) {
+        if (j == b.size() || (i < a.size() && !better<T, Largest>(b[j], a[i]))) {
+            merged.push_back(a[i++]);
+        } else {
+            merged.push_back(b[j++]);
+        }
+    }
+    return merged;
+}
+
+// Добавляет в counts число значений участка по корзинам равной ширины на
+// [lo, hi]; значение hi попадает в последнюю, значения вне диапазона не учитываются
+template<typename T>
+void histogramRange(const T* data, size_t len, T lo, T hi, std::vector<size_t>& counts) {
+    size_t bins = counts.size();
+    double scale = hi > lo ? static_cast<double>(bins) / (static_cast<double>(hi) - static_cast<double>(lo)) : 0.0;
+    for (size_t i = 0; i < len; ++i) {
+        T value = data[i];
+        if (!(value >= lo && value <= hi)) {
+            continue;
+        }
+        size_t bin = static_cast<size_t>((static_cast<double>(value) - static_cast<double>(lo)) * scale);
+        counts[std::min(bin, bins - 1)]++;
+    }
+}
+
+// Ранги соседних элементов для квантиля q (линейная интерполяция между
+// элементами с рангами floor(q (n - 1)) и следующим, как numpy по умолчанию)
+inline std::pair<size_t, double> quantileRank(double q, size_t n) {
+    if (!(q >= 0.0 && q <= 1.0)) {
+        throw std::invalid_argument("Квантиль должен лежать в [0, 1]");
+    }
+    double position = q * static_cast<double>(n - 1);
+    size_t rank = static_cast<size_t>(std::floor(position));
+    return {std::min(rank, n - 1), position - static_cast<double>(rank)};
+}
+
+// Отсортированная случайная выборка из count элементов (индексы от
+// Philox с фиксированным ключом, поэтому выборка воспроизводима)
+template<typename T>
+std::vector<T> sortedSample(const T* data, size_t n, size_t count, uint64_t seed) {
+    Philox4x32 generator(seed);
+    std::vector<T> sample(count);
+    for (size_t i = 0; i < count; ++i) {
+        sample[i] = data[uniformFromBits<uint64_t>(generator.bits(i), 0, n - 1)];
+    }
+    std::sort(sample.begin(), sample.end());
+    return sample;
+}
+
+// Сколько раз выбор по рангу в процессе не сузил диапазон выборкой и
+// копировал весь вектор; для проверки, что квантили хвостов так не делают
+inline std::atomic<size_t>& fullCopySelections() {
+    static std::atomic<size_t> count{0};
+    return count;
+}
+
+// Результат прохода выборки k-го элемента: сколько значений меньше
+// нижней границы и сами значения, попавшие в [нижняя, верхняя]
+template<typename T>
+struct SelectionBucket {
+    size_t below = 0;
+    std::vector<T> candidates;
+
+    void merge(const SelectionBucket& other) {
+        below += other.below;
+        candidates.insert(candidates.end(), other.candidates.begin(), other.candidates.end());
+    }
+};
+
+// Сравнения со случайными данными непредсказуемы, поэтому проход идет без
+// ветвлений: каждое значение записывается в небольшой буфер, а позиция
+// записи сдвигается, только если значение попало между границами
+template<typename T>
+SelectionBucket<T> selectionRange(const T* data, size_t len, T lower, T upper) {
+    constexpr size_t stagingSize = 256;
+    T staging[stagingSize];
+    size_t fill = 0;
+    SelectionBucket<T> bucket;
+    for (size_t i = 0; i < len; ++i) {
+        T value = data[i];
+        bool isBelow = value < lower;
+        bool isCandidate = !isBelow & !(upper < value);
+        bucket.below += isBelow;
+        staging[fill] = value;
+        fill += isCandidate;
+        if (fill == stagingSize) {
+            bucket.candidates.insert(bucket.candidates.end(), staging, staging + fill);
+            fill = 0;
+        }
+    }
+    bucket.candidates.insert(bucket.candidates.end(), staging, staging + fill);
+    return bucket;
+}
+
+} // namespace order
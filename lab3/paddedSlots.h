@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+// Размер строки кэша, на которой соседние потоки мешают друг другу
+// (false sharing). GCC предупреждает, что значение зависит от -mtune;
+// нам это и нужно, поэтому предупреждение отключено.
+#ifdef __cpp_lib_hardware_interference_size
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+constexpr size_t cacheLineSize = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#elif defined(__APPLE__) && defined(__aarch64__)
+constexpr size_t cacheLineSize = 128;
+#else
+constexpr size_t cacheLineSize = 64;
+#endif
+
+// Ячейки результатов по одной на поток или часть. Каждая ячейка занимает
+// отдельную строку кэша, поэтому запись одного потока не вытесняет строку
+// у соседей. Накапливать значение нужно в локальной переменной (регистре)
+// и записывать в ячейку один раз в конце части.
+template<typename T>
+class PaddedSlots {
+private:
+    struct alignas(cacheLineSize) Slot {
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t count;
+
+public:
+    PaddedSlots(size_t count, const T& init) : slots(new Slot[count]), count(count) {
+        for (size_t i = 0; i < count; ++i) {
+            slots[i].value = init;
+        }
+    }
+
+    explicit PaddedSlots(size_t count) : PaddedSlots(count, T()) {}
+
+    T& operator[](size_t i) { return slots[i].value; }
+    const T& operator[](size_t i) const { return slots[i].value; }
+
+    size_t size() const { return count; }
+
+    // Обход значений по порядку ячеек
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i = 0; i < count; ++i) {
+            fn(slots[i].value);
+        }
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Аппаратные счетчики процессора через perf_event_open (только Linux).
+// Счетчики открываются с inherit, поэтому учитывают и потоки, созданные
+// после открытия: пул для измерения нужно создавать после PerfCounters и
+// уничтожать до stop(), тогда счета рабочих потоков добавятся при их выходе.
+// Если счетчики недоступны (другая ОС, контейнер, perf_event_paranoid),
+// available() возвращает false, а значения равны нулю.
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, CacheMisses, L1DMisses, DTLBMisses, EventCount };
+
+private:
+    int fds[EventCount];
+    uint64_t values[EventCount] = {};
+
+#ifdef __linux__
+    static int openEvent(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static uint64_t cacheEvent(uint64_t cache, uint64_t op, uint64_t result) {
+        return cache | (op << 8) | (result << 16);
+    }
+#endif
+
+public:
+    PerfCounters() {
+        for (int& fd : fds) {
+            fd = -1;
+        }
+#ifdef __linux__
+        fds[Cycles] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[Instructions] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[CacheMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[L1DMisses] = openEvent(PERF_TYPE_HW_CACHE,
+            cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        fds[DTLBMisses] = openEvent(PERF_TYPE_HW_CACHE,
+            cacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(Event event = Cycles) const {
+        return fds[event] >= 0;
+    }
+
+    void start() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        for (int event = 0; event < EventCount; ++event) {
+            values[event] = 0;
+            if (fds[event] >= 0) {
+                ioctl(fds[event], PERF_EVENT_IOC_DISABLE, 0);
+                if (read(fds[event], &values[event], sizeof(uint64_t)) != sizeof(uint64_t)) {
+                    values[event] = 0;
+                }
+            }
+        }
+#endif
+    }
+
+    uint64_t value(Event event) const {
+        return values[event];
+    }
+
+    // Значение для таблицы: число или "н/д", если счетчик не открылся
+    std::string format(Event event) const {
+        return available(event) ? std::to_string(values[event]) : "н/д";
+    }
+
+    static const char* name(Event event) {
+        static const char* names[EventCount] = {"cycles", "instructions", "cache-misses", "L1d-misses", "dTLB-misses"};
+        return names[event];
+    }
+};
@@ -0,0 +1,111 @@
+// Конвейер пакетной обработки: Import -> findMin и describe -> Export для
+// нескольких наборов данных, сначала строго по очереди, затем через
+// асинхронные варианты (executor.h). Во втором случае загрузка следующего
+// набора идет во второй вектор одновременно со свертками текущего, а
+// экспорт результатов - одновременно со следующим набором.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread pipeline.cpp -o pipeline.out
+// Запуск: ./pipeline.out [размер набора] [число наборов]
+
+#include "vector.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static volatile double sink;
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string inputName(size_t i) {
+    return "pipeline_in_" + std::to_string(i) + ".txt";
+}
+
+static std::string outputName(size_t i) {
+    return "pipeline_out_" + std::to_string(i) + ".txt";
+}
+
+static double runSequential(size_t n, size_t count) {
+    auto start = std::chrono::steady_clock::now();
+    Vector<double> vec(n);
+    size_t numThreads = ThreadPool::instance().size();
+    for (size_t i = 0; i < count; ++i) {
+        vec.Import(inputName(i));
+        auto [minValue, minIndex] = vec.findMinParallel(numThreads);
+        Statistics<double> stats = vec.describeParallel(numThreads);
+        sink = sink + minValue + stats.mean + static_cast<double>(minIndex);
+        vec.Export(outputName(i));
+    }
+    return secondsSince(start);
+}
+
+static double runPipelined(size_t n, size_t count) {
+    auto start = std::chrono::steady_clock::now();
+    Executor& executor = Executor::instance();
+    std::vector<Vector<double>> vectors;
+    vectors.emplace_back(n);
+    vectors.emplace_back(n);
+    std::future<void> exported[2];
+
+    std::future<void> loaded = vectors[0].importAsync(inputName(0));
+    for (size_t i = 0; i < count; ++i) {
+        Vector<double>& current = vectors[i % 2];
+        executor.await(loaded);
+
+        // Второй вектор свободен, когда выгружен его предыдущий набор
+        if (i + 1 < count) {
+            size_t other = (i + 1) % 2;
+            if (exported[other].valid()) {
+                executor.await(exported[other]);
+            }
+            loaded = vectors[other].importAsync(inputName(i + 1));
+        }
+
+        auto minFuture = current.findMinAsync();
+        auto statsFuture = current.describeAsync();
+        auto [minValue, minIndex] = executor.await(minFuture);
+        Statistics<double> stats = executor.await(statsFuture);
+        sink = sink + minValue + stats.mean + static_cast<double>(minIndex);
+        exported[i % 2] = current.exportAsync(outputName(i));
+    }
+    for (auto& future : exported) {
+        if (future.valid()) {
+            executor.await(future);
+        }
+    }
+    return secondsSince(start);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 22;
+    size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 6;
+
+    try {
+        {
+            Vector<double> source(n);
+            for (size_t i = 0; i < count; ++i) {
+                source.initializeRandom(0.0, 1.0, i + 1, ThreadPool::instance().size());
+                source.Export(inputName(i));
+            }
+        }
+
+        double sequential = runSequential(n, count);
+        double pipelined = runPipelined(n, count);
+        std::cout << "наборов: " << count << ", элементов в наборе: " << n << "\n"
+                  << "по очереди: " << sequential << " с\n"
+                  << "конвейер: " << pipelined << " с (ускорение " << sequential / pipelined << ")\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        std::remove(inputName(i).c_str());
+        std::remove(outputName(i).c_str());
+    }
+    return 0;
+}
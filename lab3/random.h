@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "numeric.h"
+
+// Счетчиковый генератор Philox4x32-10 (Salmon и др., "Parallel random
+// numbers: as easy as 1, 2, 3"). Значение зависит только от ключа и номера,
+// поэтому элемент i получает одно и то же число при любом числе потоков.
+class Philox4x32 {
+private:
+    static constexpr uint32_t multiplier0 = 0xD2511F53;
+    static constexpr uint32_t multiplier1 = 0xCD9E8D57;
+    static constexpr uint32_t weyl0 = 0x9E3779B9;
+    static constexpr uint32_t weyl1 = 0xBB67AE85;
+    static constexpr int rounds = 10;
+
+    uint32_t key0, key1;
+
+    static void mulHiLo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+        uint64_t product = static_cast<uint64_t>(a) * b;
+        hi = static_cast<uint32_t>(product >> 32);
+        lo = static_cast<uint32_t>(product);
+    }
+
+public:
+    explicit Philox4x32(uint64_t seed)
+        : key0(static_cast<uint32_t>(seed)), key1(static_cast<uint32_t>(seed >> 32)) {}
+
+    // Четыре 32-битных случайных слова для номера counter
+    std::array<uint32_t, 4> operator()(uint64_t counter) const {
+        uint32_t c0 = static_cast<uint32_t>(counter);
+        uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+        uint32_t c2 = 0, c3 = 0;
+        uint32_t k0 = key0, k1 = key1;
+        for (int round = 0; round < rounds; ++round) {
+            uint32_t hi0, lo0, hi1, lo1;
+            mulHiLo(multiplier0, c0, hi0, lo0);
+            mulHiLo(multiplier1, c2, hi1, lo1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+            k0 += weyl0;
+            k1 += weyl1;
+        }
+        return {c0, c1, c2, c3};
+    }
+
+    // 64 случайных бита для номера counter
+    uint64_t bits(uint64_t counter) const {
+        auto words = (*this)(counter);
+        return (static_cast<uint64_t>(words[0]) << 32) | words[1];
+    }
+};
+
+// Равномерное значение из [minValue, maxValue) для вещественных T и из
+// [minValue, maxValue] для целых, построенное из 64 случайных бит
+// (half и bfloat16 округляются из float и могут дать maxValue)
+template<typename T>
+T uniformFromBits(uint64_t bits, T minValue, T maxValue) {
+    if constexpr (std::is_floating_point_v<T>) {
+        // 53 старших бита дают равномерное double из [0, 1)
+        double unit = static_cast<double>(bits >> 11) * 0x1.0p-53;
+        T value = static_cast<T>(minValue + unit * (maxValue - minValue));
+        // Умножение и приведение к T (особенно к float) могут округлить
+        // значение вверх до maxValue: берем ближайшее меньшее
+        if (value >= maxValue && minValue < maxValue) {
+            value = std::nextafter(maxValue, minValue);
+        }
+        return value;
+    } else if constexpr (numeric::isReducedFloat<T>) {
+        // Значение строится во float; округление до 16 бит может дать maxValue
+        float value = uniformFromBits(bits, static_cast<float>(minValue), static_cast<float>(maxValue));
+        return T(value);
+    } else {
+        static_assert(std::is_integral_v<T>, "Поддерживаются только арифметические типы");
+        // Ширина диапазона минус один
+        uint64_t span = static_cast<uint64_t>(maxValue) - static_cast<uint64_t>(minValue);
+        if (span == UINT64_MAX) {
+            return static_cast<T>(bits);
+        }
+        // Умножение со сдвигом (Lemire) вместо смещенного остатка от деления
+        uint64_t offset = static_cast<uint64_t>((static_cast<unsigned __int128>(bits) * (span + 1)) >> 64);
+        return static_cast<T>(static_cast<uint64_t>(minValue) + offset);
+    }
+}
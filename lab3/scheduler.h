@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "paddedSlots.h"
+#include "threadPool.h"
+
+// Расписания параллельной обработки диапазона индексов.
+//   Static       - numThreads равных частей, как было в лабораторной.
+//   Dynamic      - много мелких частей одинакового размера, потоки берут их
+//                  из общего счетчика по мере освобождения.
+//   Guided       - части уменьшаются к концу диапазона (остаток / 2p), поэтому
+//                  в начале мало накладных расходов, а в конце хорошая балансировка.
+//   WorkStealing - мелкие части заранее раздаются потокам подряд (локальность),
+//                  освободившийся поток забирает половину чужой очереди.
+// Границы частей зависят только от длины диапазона и параметров, поэтому
+// свертка частей по порядку дает одинаковый результат при любом расписании
+// выполнения.
+namespace scheduler {
+
+enum class Schedule { Static, Dynamic, Guided, WorkStealing };
+
+inline const char* scheduleName(Schedule schedule) {
+    switch (schedule) {
+        case Schedule::Dynamic: return "dynamic";
+        case Schedule::Guided: return "guided";
+        case Schedule::WorkStealing: return "stealing";
+        default: return "static";
+    }
+}
+
+// Наименьшая часть по умолчанию: меньше нее накладные расходы заметнее работы
+constexpr size_t defaultMinGrain = 4096;
+// Сколько частей на поток создают Dynamic и WorkStealing при grain = 0
+constexpr size_t tasksPerThread = 16;
+
+// Границы частей [from, to): части i соответствует [bounds[i], bounds[i + 1]).
+// grain - размер части для Dynamic/WorkStealing и минимальный размер для Guided,
+// 0 - выбрать автоматически.
+inline std::vector<size_t> partition(size_t from, size_t to, size_t numThreads, Schedule schedule, size_t grain = 0) {
+    if (numThreads == 0) {
+        throw std::invalid_argument("Число потоков должно быть положительным");
+    }
+    size_t length = to - from;
+    std::vector<size_t> bounds;
+    if (schedule == Schedule::Static) {
+        size_t chunkSize = length / numThreads;
+        bounds.reserve(numThreads + 1);
+        for (size_t i = 0; i < numThreads; ++i) {
+            bounds.push_back(from + i * chunkSize);
+        }
+        bounds.push_back(to);
+        return bounds;
+    }
+
+    if (grain == 0) {
+        grain = schedule == Schedule::Guided
+            ? defaultMinGrain
+            : std::max(defaultMinGrain, length / (numThreads * tasksPerThread));
+    }
+    bounds.push_back(from);
+    size_t position = from;
+    while (position < to) {
+        size_t remaining = to - position;
+        size_t size = schedule == Schedule::Guided
+            ? std::max(grain, remaining / (2 * numThreads))
+            : grain;
+        position += std::min(size, remaining);
+        bounds.push_back(position);
+    }
+    if (bounds.size() == 1) {
+        bounds.push_back(to);
+    }
+    return bounds;
+}
+
+// Очереди задач потоков для WorkStealing. Задачи - номера частей, поэтому
+// очередь хранится как диапазон [begin, end): владелец берет задачи с начала,
+// вор забирает вторую половину.
+class StealingQueues {
+private:
+    struct alignas(cacheLineSize) Queue {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+    std::unique_ptr<Queue[]> queues;
+    size_t count;
+
+public:
+    StealingQueues(size_t numTasks, size_t numWorkers)
+        : queues(new Queue[numWorkers]), count(numWorkers) {
+        for (size_t w = 0; w < numWorkers; ++w) {
+            queues[w].begin = numTasks * w / numWorkers;
+            queues[w].end = numTasks * (w + 1) / numWorkers;
+        }
+    }
+
+    bool popOwn(size_t worker, size_t& task) {
+        Queue& own = queues[worker];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (own.begin == own.end) {
+            return false;
+        }
+        task = own.begin++;
+        return true;
+    }
+
+    // Ищет непустую чужую очередь, забирает ее вторую половину себе и
+    // возвращает первую из украденных задач
+    bool steal(size_t worker, size_t& task) {
+        for (size_t shift = 1; shift < count; ++shift) {
+            Queue& victim = queues[(worker + shift) % count];
+            size_t stolenBegin, stolenEnd;
+            {
+                std::lock_guard<std::mutex> lock(victim.lock);
+                size_t available = victim.end - victim.begin;
+                if (available == 0) {
+                    continue;
+                }
+                stolenEnd = victim.end;
+                stolenBegin = victim.end - (available + 1) / 2;
+                victim.end = stolenBegin;
+            }
+            Queue& own = queues[worker];
+            std::lock_guard<std::mutex> lock(own.lock);
+            own.begin = stolenBegin + 1;
+            own.end = stolenEnd;
+            task = stolenBegin;
+            return true;
+        }
+        return false;
+    }
+};
+
+// Выполняет fn(task) для всех task из [0, numTasks) в общем пуле по расписанию.
+// Задачи выполняют не больше numThreads потоков: в пул отдается
+// min(numThreads, numTasks) заданий-исполнителей, и каждое берет задачи
+// по расписанию: Static - свою фиксированную часть, Dynamic/Guided - из общего
+// счетчика, WorkStealing - из своей очереди, а затем из чужих.
+template<typename F>
+void run(size_t numTasks, size_t numThreads, Schedule schedule, F&& fn) {
+    size_t numWorkers = std::min(numThreads, numTasks);
+    if (numWorkers <= 1) {
+        for (size_t task = 0; task < numTasks; ++task) {
+            fn(task);
+        }
+        return;
+    }
+    ThreadPool& pool = ThreadPool::instance();
+    if (schedule == Schedule::Static) {
+        pool.run(numWorkers, [&](size_t worker) {
+            size_t end = numTasks * (worker + 1) / numWorkers;
+            for (size_t task = numTasks * worker / numWorkers; task < end; ++task) {
+                fn(task);
+            }
+        });
+        return;
+    }
+    if (schedule != Schedule::WorkStealing) {
+        alignas(cacheLineSize) std::atomic<size_t> nextTask{0};
+        pool.run(numWorkers, [&](size_t) {
+            for (size_t task = nextTask.fetch_add(1); task < numTasks; task = nextTask.fetch_add(1)) {
+                fn(task);
+            }
+        });
+        return;
+    }
+    StealingQueues queues(numTasks, numWorkers);
+    pool.run(numWorkers, [&](size_t worker) {
+        size_t task;
+        while (queues.popOwn(worker, task) || queues.steal(worker, task)) {
+            fn(task);
+        }
+    });
+}
+
+} // namespace scheduler
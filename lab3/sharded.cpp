@@ -0,0 +1,59 @@
+// Вектор в разделяемой памяти (sharedMemory.h): координатор раздает
+// диапазоны индексов рабочим процессам, которые считают минимум, максимум
+// и сумму своих частей, а другой вектор подключается к тем же данным только
+// для чтения без копирования.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread sharded.cpp -o sharded.out
+// Запуск: ./sharded.out [размер] [максимум рабочих процессов]
+
+#include "vector.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 25;
+    size_t maxWorkers = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+    std::string name = "/lab3_vector_" + std::to_string(getpid());
+
+    try {
+        Vector<double> source(n);
+        source.initializeRandom(0.0, 1.0, 42, ThreadPool::instance().size());
+        source.ExportShared(name);
+
+        auto shared = shm::SharedVector<double>::attach(name, false);
+        auto start = std::chrono::steady_clock::now();
+        BlockSummary<double> reference = summarizeRange(shared.data(), shared.size(), 0);
+        double singleSeconds = secondsSince(start);
+        std::cout << "один процесс: " << singleSeconds * 1000 << " мс, минимум " << reference.min << " ["
+                  << reference.minIndex << "], сумма " << reference.sum << "\n";
+
+        for (size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+            start = std::chrono::steady_clock::now();
+            BlockSummary<double> summary = shared.summarizeSharded(workers);
+            double seconds = secondsSince(start);
+            std::cout << workers << " рабочих: " << seconds * 1000 << " мс (ускорение " << singleSeconds / seconds
+                      << "), минимум " << summary.min << " [" << summary.minIndex << "], максимум " << summary.max
+                      << " [" << summary.maxIndex << "], сумма " << summary.sum << "\n";
+        }
+
+        // Второй потребитель тех же данных: страницы сегмента без копии
+        Vector<double> reader(n);
+        reader.ImportShared(name);
+        auto [minValue, minIndex] = reader.findMinParallel(ThreadPool::instance().size());
+        std::cout << "подключенный вектор: минимум " << minValue << " [" << minIndex << "]\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+    }
+
+    shm::remove(name);
+    return 0;
+}
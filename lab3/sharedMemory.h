@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "allocators.h"
+#include "binaryFormat.h"
+#include "paddedSlots.h"
+#include "summaryIndex.h"
+#include "vectorView.h"
+
+// Вектор в разделяемой памяти POSIX (shm_open + mmap). Сегмент имеет имя
+// вида "/имя" и живет до shm::remove или перезагрузки, поэтому несколько
+// процессов аналитики подключаются к одним данным без копирования, а
+// координатор раздает диапазоны индексов рабочим процессам.
+//
+// Раскладка сегмента:
+//   SegmentHeader (64 байта), данные с выравниванием 64, затем maxWorkers
+//   ячеек результатов ResultSlot<T>, каждая в своей строке кэша.
+// Рабочий процесс пишет сводку своего диапазона в свою ячейку и публикует
+// ее записью номера задания (release); координатор читает ячейки после
+// завершения рабочих (acquire). Блокировок в области результатов нет.
+namespace shm {
+
+constexpr char magic[8] = {'V', 'E', 'C', 'T', 'O', 'R', 'S', 'M'};
+constexpr uint32_t layoutVersion = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Счетчики в разделяемой памяти должны быть атомарными без блокировок");
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t typeTag;
+    uint32_t elementSize;
+    uint32_t maxWorkers;
+    uint64_t count;
+    uint64_t dataOffset;
+    uint64_t resultOffset;
+    std::atomic<uint64_t> job;   // номер последнего задания координатора
+    uint8_t reserved[8];
+};
+static_assert(sizeof(SegmentHeader) == 64, "Заголовок должен занимать 64 байта");
+
+template<typename T>
+struct alignas(cacheLineSize) ResultSlot {
+    std::atomic<uint64_t> job;   // номер задания, для которого записана summary
+    BlockSummary<T> summary;
+};
+
+// Отображение именованного сегмента, владеет отображением, но не именем
+class SharedSegment {
+private:
+    void* address = nullptr;
+    size_t length = 0;
+    bool writable = false;
+
+    void unmap() {
+        if (address) {
+            munmap(address, length);
+            address = nullptr;
+            length = 0;
+        }
+    }
+
+    SharedSegment(void* address, size_t length, bool writable)
+        : address(address), length(length), writable(writable) {}
+
+public:
+    SharedSegment() = default;
+
+    // Новый сегмент из bytes нулевых байт; ошибка, если имя занято
+    static SharedSegment create(const std::string& name, size_t bytes) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Не удается создать сегмент " + name + ": " + std::strerror(errno));
+        }
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            int error = errno;
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("Не удается задать размер сегмента " + name + ": " + std::strerror(error));
+        }
+        void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw std::runtime_error("Не удалось отобразить сегмент " + name);
+        }
+        return SharedSegment(address, bytes, true);
+    }
+
+    // Подключение к существующему сегменту
+    static SharedSegment open(const std::string& name, bool readOnly) {
+        int fd = shm_open(name.c_str(), readOnly ? O_RDONLY : O_RDWR, 0);
+        if (fd < 0) {
+            throw std::runtime_error("Не удается открыть сегмент " + name + ": " + std::strerror(errno));
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("Пустой или недоступный сегмент " + name);
+        }
+        size_t bytes = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, bytes, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            throw std::runtime_error("Не удалось отобразить сегмент " + name);
+        }
+        return SharedSegment(address, bytes, !readOnly);
+    }
+
+    ~SharedSegment() {
+        unmap();
+    }
+
+    SharedSegment(const SharedSegment&) = delete;
+    SharedSegment& operator=(const SharedSegment&) = delete;
+
+    SharedSegment(SharedSegment&& other) noexcept
+        : address(std::exchange(other.address, nullptr)), length(std::exchange(other.length, 0)), writable(other.writable) {}
+
+    SharedSegment& operator=(SharedSegment&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            address = std::exchange(other.address, nullptr);
+            length = std::exchange(other.length, 0);
+            writable = other.writable;
+        }
+        return *this;
+    }
+
+    bool isMapped() const { return address != nullptr; }
+    bool isWritable() const { return writable; }
+    char* bytes() const { return static_cast<char*>(address); }
+    size_t size() const { return length; }
+};
+
+// Удаляет имя сегмента; подключенные процессы сохраняют свои отображения
+inline void remove(const std::string& name) {
+    shm_unlink(name.c_str());
+}
+
+// Вектор из count элементов T в именованном сегменте
+template<typename T>
+class SharedVector {
+private:
+    SharedSegment segment;
+
+    static constexpr size_t defaultMaxWorkers = 64;
+
+    SegmentHeader& header() const {
+        return *reinterpret_cast<SegmentHeader*>(segment.bytes());
+    }
+
+    ResultSlot<T>* slots() const {
+        return reinterpret_cast<ResultSlot<T>*>(segment.bytes() + header().resultOffset);
+    }
+
+    explicit SharedVector(SharedSegment&& mapped) : segment(std::move(mapped)) {}
+
+    void validate(const std::string& name) const {
+        if (segment.size() < sizeof(SegmentHeader)) {
+            throw std::runtime_error("Сегмент " + name + " короче заголовка");
+        }
+        const SegmentHeader& h = header();
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0 || h.version != layoutVersion) {
+            throw std::runtime_error("Сегмент " + name + " не содержит вектор");
+        }
+        if (h.typeTag != binary::typeTag<T>() || h.elementSize != sizeof(T)) {
+            throw std::runtime_error("Тип элементов сегмента не совпадает с типом вектора");
+        }
+        if (h.resultOffset + h.maxWorkers * sizeof(ResultSlot<T>) > segment.size() ||
+            h.dataOffset + h.count * sizeof(T) > h.resultOffset) {
+            throw std::runtime_error("Размер сегмента " + name + " не совпадает с заголовком");
+        }
+    }
+
+public:
+    // Новый сегмент; элементы заполнены нулями
+    static SharedVector create(const std::string& name, size_t count, size_t maxWorkers = defaultMaxWorkers) {
+        static_assert(binary::typeTag<T>() != binary::Unknown, "Тип не поддерживается разделяемым вектором");
+        if (count == 0 || maxWorkers == 0) {
+            throw std::invalid_argument("Размер и число рабочих должны быть положительными");
+        }
+        size_t dataOffset = sizeof(SegmentHeader);
+        size_t resultOffset = allocators::roundUp(dataOffset + count * sizeof(T), cacheLineSize);
+        size_t bytes = resultOffset + maxWorkers * sizeof(ResultSlot<T>);
+
+        SharedVector vec(SharedSegment::create(name, bytes));
+        SegmentHeader& h = vec.header();
+        std::memcpy(h.magic, magic, sizeof(magic));
+        h.version = layoutVersion;
+        h.typeTag = binary::typeTag<T>();
+        h.elementSize = sizeof(T);
+        h.maxWorkers = static_cast<uint32_t>(maxWorkers);
+        h.count = count;
+        h.dataOffset = dataOffset;
+        h.resultOffset = resultOffset;
+        h.job.store(0);
+        return vec;
+    }
+
+    // Подключение к сегменту, созданному другим процессом. Только для
+    // чтения нельзя запускать summarizeSharded: ей нужна область результатов.
+    static SharedVector attach(const std::string& name, bool readOnly = true) {
+        SharedVector vec(SharedSegment::open(name, readOnly));
+        vec.validate(name);
+        return vec;
+    }
+
+    size_t size() const { return header().count; }
+    size_t maxWorkers() const { return header().maxWorkers; }
+    bool isWritable() const { return segment.isWritable(); }
+
+    const T* data() const {
+        return reinterpret_cast<const T*>(segment.bytes() + header().dataOffset);
+    }
+
+    T* mutableData() {
+        if (!segment.isWritable()) {
+            throw std::logic_error("Сегмент подключен только для чтения");
+        }
+        return reinterpret_cast<T*>(segment.bytes() + header().dataOffset);
+    }
+
+    VectorView<T> view() const {
+        return VectorView<T>(data(), size());
+    }
+
+    // Минимум, максимум и сумма, посчитанные numWorkers дочерними процессами
+    // (fork) по равным диапазонам индексов. Рабочий считает свой диапазон
+    // в одном потоке векторными ядрами и завершается через _exit, не трогая
+    // пул потоков и кучу родителя. Сводки объединяются по порядку
+    // диапазонов, поэтому индексы совпадают с однопроцессным проходом.
+    // Одновременно с сегментом работает один координатор.
+    BlockSummary<T> summarizeSharded(size_t numWorkers) {
+        if (!segment.isWritable()) {
+            throw std::logic_error("Сегмент подключен только для чтения");
+        }
+        size_t n = size();
+        numWorkers = std::max<size_t>(1, std::min({numWorkers, maxWorkers(), n}));
+        uint64_t job = header().job.fetch_add(1) + 1;
+        const T* values = data();
+        ResultSlot<T>* results = slots();
+
+        std::vector<pid_t> workers;
+        workers.reserve(numWorkers);
+        for (size_t w = 0; w < numWorkers; ++w) {
+            pid_t pid = fork();
+            if (pid < 0) {
+                for (pid_t started : workers) {
+                    kill(started, SIGKILL);
+                    waitpid(started, nullptr, 0);
+                }
+                throw std::runtime_error("Не удалось запустить рабочий процесс");
+            }
+            if (pid == 0) {
+                size_t lo = n * w / numWorkers;
+                size_t hi = n * (w + 1) / numWorkers;
+                results[w].summary = summarizeRange(values + lo, hi - lo, lo);
+                results[w].job.store(job, std::memory_order_release);
+                _exit(0);
+            }
+            workers.push_back(pid);
+        }
+
+        bool failed = false;
+        for (pid_t pid : workers) {
+            int status = 0;
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            }
+            failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        }
+
+        BlockSummary<T> summary;
+        for (size_t w = 0; w < numWorkers; ++w) {
+            if (failed || results[w].job.load(std::memory_order_acquire) != job) {
+                throw std::runtime_error("Рабочий процесс " + std::to_string(w) + " не вернул результат");
+            }
+            summary.merge(results[w].summary);
+        }
+        return summary;
+    }
+};
+
+} // namespace shm
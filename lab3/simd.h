@@ -0,0 +1,705 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "numeric.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define VECTOR_SIMD_X86 0
+#endif
+
+// Векторные ядра для поиска минимума/максимума с индексом и суммы.
+// Набор инструкций выбирается один раз во время выполнения по возможностям
+// процессора, поэтому программа собирается без -mavx2 и работает везде.
+// Сумма копится в numeric::Accumulator<T> (целые - в 64 бита, float и
+// 16-битные форматы - в double). Ядра есть для double, float, целых 8/16/32
+// бит, half и bfloat16; остальные типы считаются скалярно.
+namespace simd {
+
+enum class Isa { Scalar, SSE2, AVX2, AVX512 };
+
+inline const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SSE2: return "SSE2";
+        case Isa::AVX2: return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+        default: return "scalar";
+    }
+}
+
+// Лучший набор инструкций, поддерживаемый процессором
+inline Isa detectIsa() {
+    static const Isa isa = [] {
+#if VECTOR_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return Isa::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return Isa::SSE2;
+        }
+#endif
+        return Isa::Scalar;
+    }();
+    return isa;
+}
+
+// Преобразование half во float (F16C) есть не на всех процессорах с AVX2
+inline bool hasF16c() {
+    static const bool supported = [] {
+#if VECTOR_SIMD_X86
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("f16c") != 0;
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
+
+// Скалярные версии: используются для остальных типов, для хвостов
+// и на процессорах без SIMD. Значение и индекс - как у последовательного
+// прохода со строгим сравнением (первое вхождение экстремума).
+template<bool IsMax, typename T>
+std::pair<T, size_t> argExtremumScalar(const T* data, size_t len, T best, size_t bestIndex) {
+    for (size_t i = 0; i < len; ++i) {
+        if (IsMax ? data[i] > best : data[i] < best) {
+            best = data[i];
+            bestIndex = i;
+        }
+    }
+    return {best, bestIndex};
+}
+
+template<bool IsMax, typename T>
+T extremumInit() {
+    return IsMax ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+}
+
+template<typename T>
+numeric::Accumulator<T> sumScalar(const T* data, size_t len) {
+    numeric::Accumulator<T> sum = 0;
+    for (size_t i = 0; i < len; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+namespace detail {
+
+// Свертка результатов по линиям: лучшее значение, при равенстве - меньший индекс
+template<bool IsMax, typename T, typename I>
+std::pair<T, size_t> reduceLanes(const T* values, const I* indexes, int lanes) {
+    T best = values[0];
+    size_t bestIndex = static_cast<size_t>(indexes[0]);
+    for (int lane = 1; lane < lanes; ++lane) {
+        T v = values[lane];
+        size_t idx = static_cast<size_t>(indexes[lane]);
+        bool better = IsMax ? v > best : v < best;
+        if (better || (v == best && idx < bestIndex)) {
+            best = v;
+            bestIndex = idx;
+        }
+    }
+    return {best, bestIndex};
+}
+
+// Добираем хвост скалярно и объединяем с результатом векторной части
+template<bool IsMax, typename T>
+std::pair<T, size_t> finishTail(std::pair<T, size_t> head, const T* data, size_t from, size_t len) {
+    auto tail = argExtremumScalar<IsMax>(data + from, len - from, head.first, 0);
+    if (IsMax ? tail.first > head.first : tail.first < head.first) {
+        return {tail.first, from + tail.second};
+    }
+    return head;
+}
+
+#if VECTOR_SIMD_X86
+
+// ---------- SSE2 ----------
+
+template<bool IsMax>
+__attribute__((target("sse2")))
+std::pair<double, size_t> argExtremumSse2(const double* data, size_t len) {
+    __m128d best = _mm_set1_pd(data[0]);
+    __m128i bestIdx = _mm_setzero_si128();
+    __m128i idx = _mm_set_epi64x(1, 0);
+    const __m128i step = _mm_set1_epi64x(2);
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2) {
+        __m128d v = _mm_loadu_pd(data + i);
+        __m128d mask = IsMax ? _mm_cmpgt_pd(v, best) : _mm_cmplt_pd(v, best);
+        best = _mm_or_pd(_mm_and_pd(mask, v), _mm_andnot_pd(mask, best));
+        __m128i m = _mm_castpd_si128(mask);
+        bestIdx = _mm_or_si128(_mm_and_si128(m, idx), _mm_andnot_si128(m, bestIdx));
+        idx = _mm_add_epi64(idx, step);
+    }
+    alignas(16) double values[2];
+    alignas(16) int64_t indexes[2];
+    _mm_store_pd(values, best);
+    _mm_store_si128(reinterpret_cast<__m128i*>(indexes), bestIdx);
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 2), data, i, len);
+}
+
+template<bool IsMax>
+__attribute__((target("sse2")))
+std::pair<float, size_t> argExtremumSse2(const float* data, size_t len) {
+    __m128 best = _mm_set1_ps(data[0]);
+    __m128i bestIdx = _mm_setzero_si128();
+    __m128i idx = _mm_set_epi32(3, 2, 1, 0);
+    const __m128i step = _mm_set1_epi32(4);
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m128 v = _mm_loadu_ps(data + i);
+        __m128 mask = IsMax ? _mm_cmpgt_ps(v, best) : _mm_cmplt_ps(v, best);
+        best = _mm_or_ps(_mm_and_ps(mask, v), _mm_andnot_ps(mask, best));
+        __m128i m = _mm_castps_si128(mask);
+        bestIdx = _mm_or_si128(_mm_and_si128(m, idx), _mm_andnot_si128(m, bestIdx));
+        idx = _mm_add_epi32(idx, step);
+    }
+    alignas(16) float values[4];
+    alignas(16) uint32_t indexes[4];
+    _mm_store_ps(values, best);
+    _mm_store_si128(reinterpret_cast<__m128i*>(indexes), bestIdx);
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 4), data, i, len);
+}
+
+__attribute__((target("sse2")))
+inline double sumSse2(const double* data, size_t len) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i + 2));
+        acc2 = _mm_add_pd(acc2, _mm_loadu_pd(data + i + 4));
+        acc3 = _mm_add_pd(acc3, _mm_loadu_pd(data + i + 6));
+    }
+    __m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, acc);
+    return lanes[0] + lanes[1] + sumScalar(data + i, len - i);
+}
+
+// float складываются в double: каждая четверка расширяется в две пары
+__attribute__((target("sse2")))
+inline double sumSse2(const float* data, size_t len) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m128 low = _mm_loadu_ps(data + i);
+        __m128 high = _mm_loadu_ps(data + i + 4);
+        acc0 = _mm_add_pd(acc0, _mm_cvtps_pd(low));
+        acc1 = _mm_add_pd(acc1, _mm_cvtps_pd(_mm_movehl_ps(low, low)));
+        acc2 = _mm_add_pd(acc2, _mm_cvtps_pd(high));
+        acc3 = _mm_add_pd(acc3, _mm_cvtps_pd(_mm_movehl_ps(high, high)));
+    }
+    __m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, acc);
+    return lanes[0] + lanes[1] + sumScalar(data + i, len - i);
+}
+
+template<bool IsMax>
+__attribute__((target("sse2")))
+std::pair<int32_t, size_t> argExtremumSse2(const int32_t* data, size_t len) {
+    __m128i best = _mm_set1_epi32(data[0]);
+    __m128i bestIdx = _mm_setzero_si128();
+    __m128i idx = _mm_set_epi32(3, 2, 1, 0);
+    const __m128i step = _mm_set1_epi32(4);
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i mask = IsMax ? _mm_cmpgt_epi32(v, best) : _mm_cmplt_epi32(v, best);
+        best = _mm_or_si128(_mm_and_si128(mask, v), _mm_andnot_si128(mask, best));
+        bestIdx = _mm_or_si128(_mm_and_si128(mask, idx), _mm_andnot_si128(mask, bestIdx));
+        idx = _mm_add_epi32(idx, step);
+    }
+    alignas(16) int32_t values[4];
+    alignas(16) uint32_t indexes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(values), best);
+    _mm_store_si128(reinterpret_cast<__m128i*>(indexes), bestIdx);
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 4), data, i, len);
+}
+
+// ---------- AVX2 ----------
+
+template<bool IsMax>
+__attribute__((target("avx2")))
+std::pair<double, size_t> argExtremumAvx2(const double* data, size_t len) {
+    __m256d best = _mm256_set1_pd(data[0]);
+    __m256d bestIdx = _mm256_setzero_pd(); // индексы храним как биты int64
+    __m256i idx = _mm256_set_epi64x(3, 2, 1, 0);
+    const __m256i step = _mm256_set1_epi64x(4);
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m256d v = _mm256_loadu_pd(data + i);
+        __m256d mask = _mm256_cmp_pd(v, best, IsMax ? _CMP_GT_OQ : _CMP_LT_OQ);
+        best = _mm256_blendv_pd(best, v, mask);
+        bestIdx = _mm256_blendv_pd(bestIdx, _mm256_castsi256_pd(idx), mask);
+        idx = _mm256_add_epi64(idx, step);
+    }
+    alignas(32) double values[4];
+    alignas(32) int64_t indexes[4];
+    _mm256_store_pd(values, best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indexes), _mm256_castpd_si256(bestIdx));
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 4), data, i, len);
+}
+
+template<bool IsMax>
+__attribute__((target("avx2")))
+std::pair<float, size_t> argExtremumAvx2(const float* data, size_t len) {
+    __m256 best = _mm256_set1_ps(data[0]);
+    __m256 bestIdx = _mm256_setzero_ps();
+    __m256i idx = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i step = _mm256_set1_epi32(8);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m256 v = _mm256_loadu_ps(data + i);
+        __m256 mask = _mm256_cmp_ps(v, best, IsMax ? _CMP_GT_OQ : _CMP_LT_OQ);
+        best = _mm256_blendv_ps(best, v, mask);
+        bestIdx = _mm256_blendv_ps(bestIdx, _mm256_castsi256_ps(idx), mask);
+        idx = _mm256_add_epi32(idx, step);
+    }
+    alignas(32) float values[8];
+    alignas(32) uint32_t indexes[8];
+    _mm256_store_ps(values, best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indexes), _mm256_castps_si256(bestIdx));
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 8), data, i, len);
+}
+
+__attribute__((target("avx2")))
+inline double sumAvx2(const double* data, size_t len) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(data + i + 4));
+        acc2 = _mm256_add_pd(acc2, _mm256_loadu_pd(data + i + 8));
+        acc3 = _mm256_add_pd(acc3, _mm256_loadu_pd(data + i + 12));
+    }
+    __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumScalar(data + i, len - i);
+}
+
+__attribute__((target("avx2")))
+inline double horizontalSum(__m256d acc) {
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+__attribute__((target("avx2")))
+inline int64_t horizontalSum(__m256i acc) {
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// Восемь float, расширенные до double, в два аккумулятора
+__attribute__((target("avx2")))
+inline void addWidened(__m256 v, __m256d& low, __m256d& high) {
+    low = _mm256_add_pd(low, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+    high = _mm256_add_pd(high, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+}
+
+__attribute__((target("avx2")))
+inline double sumAvx2(const float* data, size_t len) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        addWidened(_mm256_loadu_ps(data + i), acc0, acc1);
+        addWidened(_mm256_loadu_ps(data + i + 8), acc2, acc3);
+    }
+    double sum = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    return sum + sumScalar(data + i, len - i);
+}
+
+// bfloat16 - старшие половины float: расширение нулями и сдвиг на 16 бит
+__attribute__((target("avx2")))
+inline double sumAvx2(const numeric::bfloat16* data, size_t len) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i low = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(raw)), 16);
+        __m256i high = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(raw, 1)), 16);
+        addWidened(_mm256_castsi256_ps(low), acc0, acc1);
+        addWidened(_mm256_castsi256_ps(high), acc2, acc3);
+    }
+    double sum = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    return sum + sumScalar(data + i, len - i);
+}
+
+__attribute__((target("avx2,f16c")))
+inline double sumAvx2(const numeric::half* data, size_t len) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        addWidened(_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))), acc0, acc1);
+        addWidened(_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 8))), acc2, acc3);
+    }
+    double sum = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    return sum + sumScalar(data + i, len - i);
+}
+
+// int32 расширяются до int64 знаком
+__attribute__((target("avx2")))
+inline int64_t sumAvx2(const int32_t* data, size_t len) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256(), acc3 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(data + i);
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm_loadu_si128(p)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm_loadu_si128(p + 1)));
+        acc2 = _mm256_add_epi64(acc2, _mm256_cvtepi32_epi64(_mm_loadu_si128(p + 2)));
+        acc3 = _mm256_add_epi64(acc3, _mm256_cvtepi32_epi64(_mm_loadu_si128(p + 3)));
+    }
+    int64_t sum = horizontalSum(_mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3)));
+    return sum + sumScalar(data + i, len - i);
+}
+
+// Попарные суммы int16 (madd с единицами) копятся в int32 блоками, которые
+// не могут переполниться, и затем переносятся в int64
+constexpr size_t int16PairBlock = size_t(1) << 14;
+
+__attribute__((target("avx2")))
+inline int64_t sumAvx2(const int16_t* data, size_t len) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    size_t full = len - len % 16;
+    while (i < full) {
+        size_t blockEnd = std::min(full, i + 16 * int16PairBlock);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i < blockEnd; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(v, ones));
+        }
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(acc)));
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(acc, 1)));
+    }
+    return horizontalSum(total) + sumScalar(data + i, len - i);
+}
+
+// Байты суммируются psadbw в четыре 64-битные линии; знаковые сначала
+// сдвигаются в беззнаковые (x ^ 0x80 = x + 128), лишнее вычитается в конце
+__attribute__((target("avx2")))
+inline uint64_t sumBytesAvx2(const void* data, size_t len, bool isSigned) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const __m256i bias = _mm256_set1_epi8(isSigned ? static_cast<char>(0x80) : 0);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i v0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i)), bias);
+        __m256i v1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i + 32)), bias);
+        acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(v0, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(v1, zero));
+    }
+    return static_cast<uint64_t>(horizontalSum(_mm256_add_epi64(acc0, acc1)));
+}
+
+__attribute__((target("avx2")))
+inline int64_t sumAvx2(const int8_t* data, size_t len) {
+    size_t full = len - len % 64;
+    int64_t biased = static_cast<int64_t>(sumBytesAvx2(data, full, true));
+    return biased - 128 * static_cast<int64_t>(full) + sumScalar(data + full, len - full);
+}
+
+__attribute__((target("avx2")))
+inline uint64_t sumAvx2(const uint8_t* data, size_t len) {
+    size_t full = len - len % 64;
+    return sumBytesAvx2(data, full, false) + sumScalar(data + full, len - full);
+}
+
+template<bool IsMax>
+__attribute__((target("avx2")))
+std::pair<int32_t, size_t> argExtremumAvx2(const int32_t* data, size_t len) {
+    __m256i best = _mm256_set1_epi32(data[0]);
+    __m256i bestIdx = _mm256_setzero_si256();
+    __m256i idx = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i step = _mm256_set1_epi32(8);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i mask = IsMax ? _mm256_cmpgt_epi32(v, best) : _mm256_cmpgt_epi32(best, v);
+        best = _mm256_blendv_epi8(best, v, mask);
+        bestIdx = _mm256_blendv_epi8(bestIdx, idx, mask);
+        idx = _mm256_add_epi32(idx, step);
+    }
+    alignas(32) int32_t values[8];
+    alignas(32) uint32_t indexes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(values), best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indexes), bestIdx);
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 8), data, i, len);
+}
+
+// ---------- AVX-512 ----------
+
+template<bool IsMax>
+__attribute__((target("avx512f")))
+std::pair<double, size_t> argExtremumAvx512(const double* data, size_t len) {
+    __m512d best = _mm512_set1_pd(data[0]);
+    __m512i bestIdx = _mm512_setzero_si512();
+    __m512i idx = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i step = _mm512_set1_epi64(8);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m512d v = _mm512_loadu_pd(data + i);
+        __mmask8 mask = _mm512_cmp_pd_mask(v, best, IsMax ? _CMP_GT_OQ : _CMP_LT_OQ);
+        best = _mm512_mask_mov_pd(best, mask, v);
+        bestIdx = _mm512_mask_mov_epi64(bestIdx, mask, idx);
+        idx = _mm512_add_epi64(idx, step);
+    }
+    alignas(64) double values[8];
+    alignas(64) int64_t indexes[8];
+    _mm512_store_pd(values, best);
+    _mm512_store_si512(indexes, bestIdx);
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 8), data, i, len);
+}
+
+template<bool IsMax>
+__attribute__((target("avx512f")))
+std::pair<float, size_t> argExtremumAvx512(const float* data, size_t len) {
+    __m512 best = _mm512_set1_ps(data[0]);
+    __m512i bestIdx = _mm512_setzero_si512();
+    __m512i idx = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i step = _mm512_set1_epi32(16);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m512 v = _mm512_loadu_ps(data + i);
+        __mmask16 mask = _mm512_cmp_ps_mask(v, best, IsMax ? _CMP_GT_OQ : _CMP_LT_OQ);
+        best = _mm512_mask_mov_ps(best, mask, v);
+        bestIdx = _mm512_mask_mov_epi32(bestIdx, mask, idx);
+        idx = _mm512_add_epi32(idx, step);
+    }
+    alignas(64) float values[16];
+    alignas(64) uint32_t indexes[16];
+    _mm512_store_ps(values, best);
+    _mm512_store_si512(indexes, bestIdx);
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 16), data, i, len);
+}
+
+__attribute__((target("avx512f")))
+inline double sumAvx512(const double* data, size_t len) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        acc0 = _mm512_add_pd(acc0, _mm512_loadu_pd(data + i));
+        acc1 = _mm512_add_pd(acc1, _mm512_loadu_pd(data + i + 8));
+        acc2 = _mm512_add_pd(acc2, _mm512_loadu_pd(data + i + 16));
+        acc3 = _mm512_add_pd(acc3, _mm512_loadu_pd(data + i + 24));
+    }
+    __m512d acc = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, acc);
+    double sum = 0;
+    for (double lane : lanes) {
+        sum += lane;
+    }
+    return sum + sumScalar(data + i, len - i);
+}
+
+// Преобразования с маской всех линий: варианты без маски в GCC 12 дают
+// ложные предупреждения о неинициализированном регистре
+constexpr __mmask8 allLanes = 0xff;
+
+__attribute__((target("avx512f")))
+inline double sumAvx512(const float* data, size_t len) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        acc0 = _mm512_add_pd(acc0, _mm512_maskz_cvtps_pd(allLanes, _mm256_loadu_ps(data + i)));
+        acc1 = _mm512_add_pd(acc1, _mm512_maskz_cvtps_pd(allLanes, _mm256_loadu_ps(data + i + 8)));
+        acc2 = _mm512_add_pd(acc2, _mm512_maskz_cvtps_pd(allLanes, _mm256_loadu_ps(data + i + 16)));
+        acc3 = _mm512_add_pd(acc3, _mm512_maskz_cvtps_pd(allLanes, _mm256_loadu_ps(data + i + 24)));
+    }
+    __m512d acc = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, acc);
+    double sum = 0;
+    for (double lane : lanes) {
+        sum += lane;
+    }
+    return sum + sumScalar(data + i, len - i);
+}
+
+__attribute__((target("avx512f")))
+inline int64_t sumAvx512(const int32_t* data, size_t len) {
+    __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+    __m512i acc2 = _mm512_setzero_si512(), acc3 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(data + i);
+        acc0 = _mm512_add_epi64(acc0, _mm512_maskz_cvtepi32_epi64(allLanes, _mm256_loadu_si256(p)));
+        acc1 = _mm512_add_epi64(acc1, _mm512_maskz_cvtepi32_epi64(allLanes, _mm256_loadu_si256(p + 1)));
+        acc2 = _mm512_add_epi64(acc2, _mm512_maskz_cvtepi32_epi64(allLanes, _mm256_loadu_si256(p + 2)));
+        acc3 = _mm512_add_epi64(acc3, _mm512_maskz_cvtepi32_epi64(allLanes, _mm256_loadu_si256(p + 3)));
+    }
+    __m512i acc = _mm512_add_epi64(_mm512_add_epi64(acc0, acc1), _mm512_add_epi64(acc2, acc3));
+    alignas(64) int64_t lanes[8];
+    _mm512_store_si512(lanes, acc);
+    int64_t sum = 0;
+    for (int64_t lane : lanes) {
+        sum += lane;
+    }
+    return sum + sumScalar(data + i, len - i);
+}
+
+template<bool IsMax>
+__attribute__((target("avx512f")))
+std::pair<int32_t, size_t> argExtremumAvx512(const int32_t* data, size_t len) {
+    __m512i best = _mm512_set1_epi32(data[0]);
+    __m512i bestIdx = _mm512_setzero_si512();
+    __m512i idx = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i step = _mm512_set1_epi32(16);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m512i v = _mm512_loadu_si512(data + i);
+        __mmask16 mask = _mm512_cmp_epi32_mask(v, best, IsMax ? _MM_CMPINT_NLE : _MM_CMPINT_LT);
+        best = _mm512_mask_mov_epi32(best, mask, v);
+        bestIdx = _mm512_mask_mov_epi32(bestIdx, mask, idx);
+        idx = _mm512_add_epi32(idx, step);
+    }
+    alignas(64) int32_t values[16];
+    alignas(64) uint32_t indexes[16];
+    _mm512_store_si512(values, best);
+    _mm512_store_si512(indexes, bestIdx);
+    return finishTail<IsMax>(reduceLanes<IsMax>(values, indexes, 16), data, i, len);
+}
+
+#endif // VECTOR_SIMD_X86
+
+// Типы, для которых есть векторные ядра на каждом уровне
+template<typename T>
+constexpr bool hasExtremumKernels = std::is_same_v<T, double> || std::is_same_v<T, float> || std::is_same_v<T, int32_t>;
+
+template<typename T>
+constexpr bool hasSse2Sum = std::is_same_v<T, double> || std::is_same_v<T, float>;
+
+template<typename T>
+constexpr bool hasAvx2Sum = hasSse2Sum<T> || std::is_same_v<T, int32_t> || std::is_same_v<T, int16_t> ||
+                            std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t> || numeric::isReducedFloat<T>;
+
+template<typename T>
+constexpr bool hasAvx512Sum = hasSse2Sum<T> || std::is_same_v<T, int32_t>;
+
+// Индексы 32-битных линий 32-битные, поэтому длинные массивы режем на блоки
+constexpr size_t maxBlockForLaneIndex = size_t(1) << 30;
+
+template<bool IsMax, typename T>
+std::pair<T, size_t> argExtremumDispatch(const T* data, size_t len) {
+#if VECTOR_SIMD_X86
+    switch (detectIsa()) {
+        case Isa::AVX512: return argExtremumAvx512<IsMax>(data, len);
+        case Isa::AVX2: return argExtremumAvx2<IsMax>(data, len);
+        case Isa::SSE2: return argExtremumSse2<IsMax>(data, len);
+        default: break;
+    }
+#endif
+    return argExtremumScalar<IsMax>(data, len, data[0], 0);
+}
+
+// len > 0: линии векторных ядер начинают с элемента 0 и его индекса, поэтому
+// результат - всегда элемент массива, даже если все элементы равны
+// бесконечности того же знака, что и экстремум
+template<bool IsMax, typename T>
+std::pair<T, size_t> argExtremumBlocked(const T* data, size_t len) {
+    std::pair<T, size_t> best = argExtremumDispatch<IsMax>(data, std::min(maxBlockForLaneIndex, len));
+    for (size_t from = maxBlockForLaneIndex; from < len; from += maxBlockForLaneIndex) {
+        size_t blockLen = std::min(maxBlockForLaneIndex, len - from);
+        auto block = argExtremumDispatch<IsMax>(data + from, blockLen);
+        if (IsMax ? block.first > best.first : block.first < best.first) {
+            best = {block.first, from + block.second};
+        }
+    }
+    return best;
+}
+
+// Лучшее ядро суммы для T на этом процессоре: на машинах с AVX-512 типы без
+// 512-битного ядра используют AVX2
+template<typename T>
+numeric::Accumulator<T> sumDispatch(const T* data, size_t len) {
+#if VECTOR_SIMD_X86
+    Isa isa = detectIsa();
+    if constexpr (hasAvx512Sum<T>) {
+        if (isa == Isa::AVX512) {
+            return sumAvx512(data, len);
+        }
+    }
+    if constexpr (hasAvx2Sum<T>) {
+        bool f16cReady = !std::is_same_v<T, numeric::half> || hasF16c();
+        if (isa >= Isa::AVX2 && f16cReady) {
+            return sumAvx2(data, len);
+        }
+    }
+    if constexpr (hasSse2Sum<T>) {
+        if (isa >= Isa::SSE2) {
+            return sumSse2(data, len);
+        }
+    }
+#endif
+    return sumScalar(data, len);
+}
+
+} // namespace detail
+
+// Минимум и индекс его первого вхождения в data[0, len). Проход начинается
+// с элемента 0, поэтому результат - всегда элемент массива; для пустого
+// массива возвращается {numeric_limits<T>::max(), 0}.
+template<typename T>
+std::pair<T, size_t> argMin(const T* data, size_t len) {
+    if (len == 0) {
+        return {extremumInit<false, T>(), 0};
+    }
+    if constexpr (detail::hasExtremumKernels<T>) {
+        return detail::argExtremumBlocked<false>(data, len);
+    } else {
+        return argExtremumScalar<false>(data, len, data[0], 0);
+    }
+}
+
+// Максимум и индекс его первого вхождения в data[0, len); для пустого
+// массива - {numeric_limits<T>::lowest(), 0}
+template<typename T>
+std::pair<T, size_t> argMax(const T* data, size_t len) {
+    if (len == 0) {
+        return {extremumInit<true, T>(), 0};
+    }
+    if constexpr (detail::hasExtremumKernels<T>) {
+        return detail::argExtremumBlocked<true>(data, len);
+    } else {
+        return argExtremumScalar<true>(data, len, data[0], 0);
+    }
+}
+
+// Сумма data[0, len) в numeric::Accumulator<T> с несколькими независимыми
+// аккумуляторами
+template<typename T>
+numeric::Accumulator<T> sum(const T* data, size_t len) {
+    return detail::sumDispatch(data, len);
+}
+
+} // namespace simd
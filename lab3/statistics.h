@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "simd.h"
+
+// Сводные характеристики последовательности, собираемые за один проход:
+// минимум и максимум с индексами, сумма, среднее и сумма квадратов
+// отклонений от среднего (m2), из которой получается дисперсия.
+template<typename T>
+struct Statistics {
+    T min = std::numeric_limits<T>::max();
+    size_t minIndex = 0;
+    T max = std::numeric_limits<T>::lowest();
+    size_t maxIndex = 0;
+    numeric::Accumulator<T> sum = 0;   // в расширенном типе, см. numeric.h
+    double mean = 0.0;
+    double m2 = 0.0;
+    size_t count = 0;
+
+    // Дисперсия генеральной совокупности
+    double variance() const {
+        return count > 0 ? m2 / static_cast<double>(count) : 0.0;
+    }
+
+    // Объединение с характеристиками следующего по порядку участка
+    // (формула Чана для среднего и m2). При равных экстремумах остается
+    // индекс из более раннего участка.
+    void merge(const Statistics& other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        if (other.min < min) {
+            min = other.min;
+            minIndex = other.minIndex;
+        }
+        if (other.max > max) {
+            max = other.max;
+            maxIndex = other.maxIndex;
+        }
+        sum += other.sum;
+
+        double total = static_cast<double>(count + other.count);
+        double delta = other.mean - mean;
+        mean += delta * static_cast<double>(other.count) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+        count += other.count;
+    }
+};
+
+// Размер блока, который целиком лежит в L1/L2: по нему делается несколько
+// быстрых проходов, а память при этом читается только один раз
+constexpr size_t statisticsBlockSize = 4096;
+
+// Сумма квадратов отклонений от mean с независимыми аккумуляторами
+template<typename T>
+double squaredDeviations(const T* data, size_t len, double mean) {
+    double acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        double d0 = static_cast<double>(data[i]) - mean;
+        double d1 = static_cast<double>(data[i + 1]) - mean;
+        double d2 = static_cast<double>(data[i + 2]) - mean;
+        double d3 = static_cast<double>(data[i + 3]) - mean;
+        acc0 += d0 * d0;
+        acc1 += d1 * d1;
+        acc2 += d2 * d2;
+        acc3 += d3 * d3;
+    }
+    for (; i < len; ++i) {
+        double d = static_cast<double>(data[i]) - mean;
+        acc0 += d * d;
+    }
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+// Характеристики участка data[0, len); индексы сдвигаются на offset
+template<typename T>
+Statistics<T> describeRange(const T* data, size_t len, size_t offset) {
+    Statistics<T> result;
+    for (size_t from = 0; from < len; from += statisticsBlockSize) {
+        size_t blockLen = std::min(statisticsBlockSize, len - from);
+        const T* block = data + from;
+
+        Statistics<T> part;
+        auto [minValue, minIndex] = simd::argMin(block, blockLen);
+        auto [maxValue, maxIndex] = simd::argMax(block, blockLen);
+        part.min = minValue;
+        part.minIndex = offset + from + minIndex;
+        part.max = maxValue;
+        part.maxIndex = offset + from + maxIndex;
+        part.sum = simd::sum(block, blockLen);
+        part.count = blockLen;
+        part.mean = static_cast<double>(part.sum) / static_cast<double>(blockLen);
+        part.m2 = squaredDeviations(block, blockLen, part.mean);
+
+        result.merge(part);
+    }
+    return result;
+}
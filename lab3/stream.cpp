@@ -0,0 +1,113 @@
+// Потоковые характеристики файла больше бюджета памяти (vectorStream.h):
+// двоичный файл вектора читается блоками в два буфера, пока пул считает
+// предыдущий блок. Скорость сравнивается с простым последовательным read()
+// того же файла, а результат - с Vector::describe после полного импорта.
+// Перед каждым проходом страницы файла по возможности выгружаются из кэша
+// (fdatasync + POSIX_FADV_DONTNEED), чтобы чтение шло с диска.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread stream.cpp -o stream.out
+// Запуск: ./stream.out [размер] [бюджет, МБ] [потоки]
+
+#include "vector.h"
+#include "vectorStream.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Сбрасывает файл на диск и просит ядро выгрузить его страницы из кэша
+static void dropCache(const std::string& name) {
+    int fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    fdatasync(fd);
+#ifdef POSIX_FADV_DONTNEED
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    close(fd);
+}
+
+// Последовательное чтение всего файла блоками blockBytes: предел скорости
+// для потокового прохода
+static size_t readSequential(const std::string& name, size_t blockBytes) {
+    int fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Не удается открыть файл " + name);
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    std::vector<char> buffer(blockBytes);
+    size_t total = 0;
+    ssize_t got;
+    while ((got = read(fd, buffer.data(), buffer.size())) > 0) {
+        total += static_cast<size_t>(got);
+    }
+    close(fd);
+    if (got < 0) {
+        throw std::runtime_error("Ошибка чтения файла");
+    }
+    return total;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 25;
+    size_t budget = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16) << 20;
+    size_t numThreads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : ThreadPool::instance().size();
+    std::string name = "stream_" + std::to_string(getpid()) + ".bin";
+
+    try {
+        {
+            Vector<double> source(n);
+            source.initializeRandom(0.0, 1.0, 42, numThreads);
+            source.ExportBinary(name);
+        }
+        double gigabytes = static_cast<double>(n * sizeof(double) + sizeof(binary::BinaryHeader)) / 1e9;
+        std::cout << "файл " << gigabytes * 1000 << " МБ, бюджет " << (budget >> 20) << " МБ, потоков "
+                  << numThreads << "\n";
+
+        VectorStream<double> stream(name, budget);
+        dropCache(name);
+        auto start = std::chrono::steady_clock::now();
+        readSequential(name, stream.blockSize() * sizeof(double));
+        double readSeconds = secondsSince(start);
+
+        dropCache(name);
+        start = std::chrono::steady_clock::now();
+        Statistics<double> streamed = stream.describe(numThreads);
+        double streamSeconds = secondsSince(start);
+        std::cout << "read: " << gigabytes / readSeconds << " ГБ/с, VectorStream::describe: "
+                  << gigabytes / streamSeconds << " ГБ/с (" << 100.0 * readSeconds / streamSeconds
+                  << "% от read)\n";
+
+        // Тот же файл целиком в памяти: экстремумы и индексы совпадают точно,
+        // сумма и среднее - с точностью до порядка сложения
+        Vector<double> loaded(n);
+        loaded.ImportBinary(name);
+        Statistics<double> reference = loaded.describe();
+        auto nearlyEqual = [](double a, double b) { return std::abs(a - b) <= 1e-12 * std::max(1.0, std::abs(b)); };
+        bool matches = streamed.min == reference.min && streamed.minIndex == reference.minIndex &&
+                       streamed.max == reference.max && streamed.maxIndex == reference.maxIndex &&
+                       streamed.count == reference.count && nearlyEqual(streamed.sum, reference.sum) &&
+                       nearlyEqual(streamed.mean, reference.mean) && nearlyEqual(streamed.variance(), reference.variance());
+        std::cout << "минимум " << streamed.min << " [" << streamed.minIndex << "], максимум " << streamed.max << " ["
+                  << streamed.maxIndex << "], среднее " << streamed.mean
+                  << (matches ? " (совпадает с Vector::describe)" : " (не совпадает с Vector::describe)") << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+    }
+    std::remove(name.c_str());
+    return 0;
+}
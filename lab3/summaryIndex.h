@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "simd.h"
+#include "threadPool.h"
+
+// Сводка по участку данных: минимум и максимум с индексами первого
+// вхождения и сумма. Пустая сводка (count == 0) нейтральна для merge.
+template<typename T>
+struct BlockSummary {
+    T min = std::numeric_limits<T>::max();
+    T max = std::numeric_limits<T>::lowest();
+    numeric::Accumulator<T> sum = 0;
+    size_t minIndex = 0;
+    size_t maxIndex = 0;
+    size_t count = 0;
+
+    // Присоединяет сводку участка, который идет после текущего
+    void merge(const BlockSummary& other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0 || other.min < min) {
+            min = other.min;
+            minIndex = other.minIndex;
+        }
+        if (count == 0 || other.max > max) {
+            max = other.max;
+            maxIndex = other.maxIndex;
+        }
+        sum += other.sum;
+        count += other.count;
+    }
+};
+
+// Сводка участка [offset, offset + len) векторными ядрами
+template<typename T>
+BlockSummary<T> summarizeRange(const T* data, size_t len, size_t offset) {
+    BlockSummary<T> summary;
+    if (len == 0) {
+        return summary;
+    }
+    auto [minValue, minIndex] = simd::argMin(data, len);
+    auto [maxValue, maxIndex] = simd::argMax(data, len);
+    summary.min = minValue;
+    summary.minIndex = offset + minIndex;
+    summary.max = maxValue;
+    summary.maxIndex = offset + maxIndex;
+    summary.sum = simd::sum(data, len);
+    summary.count = len;
+    return summary;
+}
+
+// Индекс для повторных запросов минимума, максимума и суммы после
+// небольших изменений данных. Данные делятся на блоки по blockSize
+// элементов, над сводками блоков строится дерево отрезков. Изменение
+// только помечает блоки грязными; перед запросом грязные блоки
+// пересчитываются (O(blockSize) на блок) и обновляют путь до корня
+// (O(log числа блоков)). Если грязных блоков много, все дерево
+// перестраивается параллельно в общем пуле.
+//
+// Индекс не хранит указатель на данные: буфер передается в запросы вместе
+// с номером его версии, потому что Vector публикует новый буфер при каждой
+// записи целиком (см. versionedBuffer.h). Запрос с другим номером версии
+// перестраивает дерево. Сумма
+// складывается по блокам, поэтому для вещественных T может отличаться от
+// полного прохода в последних разрядах.
+template<typename T>
+class SummaryIndex {
+private:
+    size_t n;
+    size_t blockSize;
+    size_t numBlocks;
+    size_t leaves;                        // степень двойки >= numBlocks
+    std::vector<BlockSummary<T>> tree;    // tree[1] - корень, листья с tree[leaves]
+    std::vector<unsigned char> dirty;     // флаги блоков
+    std::vector<size_t> dirtyBlocks;      // номера грязных блоков без повторов
+    bool allDirty = true;
+    uint64_t builtVersion = 0;            // версия буфера, по которой построено дерево
+    std::mutex lock;                      // запросы из разных потоков обновляют дерево
+
+    // Доля грязных блоков, начиная с которой выгоднее перестроить все дерево
+    static constexpr size_t rebuildFraction = 8;
+
+    BlockSummary<T> summarizeBlock(const T* data, size_t block) const {
+        size_t start = block * blockSize;
+        size_t end = std::min(n, start + blockSize);
+        return summarizeRange(data + start, end - start, start);
+    }
+
+    void rebuild(const T* data) {
+        ThreadPool& pool = ThreadPool::instance();
+        size_t numTasks = std::min(numBlocks, pool.size() * 4);
+        pool.run(numTasks, [&](size_t task) {
+            size_t first = numBlocks * task / numTasks;
+            size_t last = numBlocks * (task + 1) / numTasks;
+            for (size_t block = first; block < last; ++block) {
+                tree[leaves + block] = summarizeBlock(data, block);
+            }
+        });
+        for (size_t node = leaves - 1; node > 0; --node) {
+            tree[node] = tree[2 * node];
+            tree[node].merge(tree[2 * node + 1]);
+        }
+        std::fill(dirty.begin(), dirty.end(), 0);
+        dirtyBlocks.clear();
+        allDirty = false;
+    }
+
+    void refresh(const T* data, uint64_t version) {
+        if (allDirty || version != builtVersion || dirtyBlocks.size() * rebuildFraction >= numBlocks) {
+            rebuild(data);
+            builtVersion = version;
+            return;
+        }
+        for (size_t block : dirtyBlocks) {
+            size_t node = leaves + block;
+            tree[node] = summarizeBlock(data, block);
+            for (node /= 2; node > 0; node /= 2) {
+                tree[node] = tree[2 * node];
+                tree[node].merge(tree[2 * node + 1]);
+            }
+            dirty[block] = 0;
+        }
+        dirtyBlocks.clear();
+    }
+
+    // Сводка полных блоков [first, last) по дереву, слева направо
+    BlockSummary<T> queryBlocks(size_t first, size_t last) const {
+        BlockSummary<T> left, right;
+        size_t lo = first + leaves, hi = last + leaves;
+        while (lo < hi) {
+            if (lo & 1) {
+                left.merge(tree[lo++]);
+            }
+            if (hi & 1) {
+                BlockSummary<T> node = tree[--hi];
+                node.merge(right);
+                right = node;
+            }
+            lo /= 2;
+            hi /= 2;
+        }
+        left.merge(right);
+        return left;
+    }
+
+public:
+    static constexpr size_t defaultBlockSize = 1024;
+
+    SummaryIndex(size_t size, size_t blockSize = defaultBlockSize)
+        : n(size), blockSize(blockSize), numBlocks(0), leaves(1) {
+        if (blockSize == 0) {
+            throw std::invalid_argument("Размер блока должен быть положительным");
+        }
+        numBlocks = (n + blockSize - 1) / blockSize;
+        while (leaves < numBlocks) {
+            leaves *= 2;
+        }
+        tree.assign(2 * leaves, BlockSummary<T>());
+        dirty.assign(numBlocks, 0);
+    }
+
+    size_t getBlockSize() const { return blockSize; }
+
+    // Отмечает изменение элементов [lo, hi)
+    void markDirty(size_t lo, size_t hi) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (allDirty || lo >= hi) {
+            return;
+        }
+        for (size_t block = lo / blockSize; block <= (hi - 1) / blockSize; ++block) {
+            if (!dirty[block]) {
+                dirty[block] = 1;
+                dirtyBlocks.push_back(block);
+            }
+        }
+    }
+
+    // Отмечает изменение всех данных: следующий запрос перестроит индекс
+    void markAllDirty() {
+        std::lock_guard<std::mutex> guard(lock);
+        allDirty = true;
+    }
+
+    // Сводка элементов [lo, hi) буфера data версии version: неполные крайние
+    // блоки просматриваются напрямую, полные берутся из дерева
+    BlockSummary<T> query(const T* data, uint64_t version, size_t lo, size_t hi) {
+        std::lock_guard<std::mutex> guard(lock);
+        refresh(data, version);
+        size_t firstFull = (lo + blockSize - 1) / blockSize;
+        size_t lastFull = hi / blockSize;
+        if (firstFull >= lastFull) {
+            return summarizeRange(data + lo, hi - lo, lo);
+        }
+        BlockSummary<T> summary = summarizeRange(data + lo, firstFull * blockSize - lo, lo);
+        summary.merge(queryBlocks(firstFull, lastFull));
+        summary.merge(summarizeRange(data + lastFull * blockSize, hi - lastFull * blockSize, lastFull * blockSize));
+        return summary;
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "numeric.h"
+
+// Текстовый формат вектора: значения, разделенные пробельными символами
+// (при экспорте - по одному на строку). Разбор и печать идут через
+// std::from_chars / std::to_chars: без локалей и потоков ввода-вывода,
+// а печать дает кратчайшую запись, которая читается обратно без потерь.
+namespace text {
+
+// Тип, через который элемент читается и печатается: half и bfloat16 - через
+// float (запись float-значения обратно округляется в то же 16-битное число)
+template<typename T>
+using TextType = std::conditional_t<numeric::isReducedFloat<T>, float, T>;
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Делит [begin, end) на parts частей так, чтобы границы попадали на пробелы
+// и ни одно число не оказалось разрезано. Возвращает parts + 1 границу.
+inline std::vector<const char*> splitAtSpaces(const char* begin, const char* end, size_t parts) {
+    std::vector<const char*> bounds(parts + 1);
+    size_t length = static_cast<size_t>(end - begin);
+    bounds[0] = begin;
+    for (size_t i = 1; i < parts; ++i) {
+        const char* p = std::max(begin + length / parts * i, bounds[i - 1]);
+        while (p < end && !isSpace(*p)) {
+            ++p;
+        }
+        bounds[i] = p;
+    }
+    bounds[parts] = end;
+    return bounds;
+}
+
+// Разбирает все числа участка [begin, end) и добавляет их в values
+template<typename T>
+void parseRange(const char* begin, const char* end, std::vector<T>& values) {
+    const char* p = begin;
+    while (true) {
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            return;
+        }
+        // from_chars не принимает явный плюс, а operator>> принимал
+        if (*p == '+') {
+            ++p;
+        }
+        TextType<T> value;
+        auto [next, error] = std::from_chars(p, end, value);
+        if (error != std::errc() || (next < end && !isSpace(*next))) {
+            throw std::runtime_error("Ошибка формата: неверное число \"" +
+                                     std::string(p, std::min<size_t>(end - p, 32)) + "\"");
+        }
+        values.push_back(static_cast<T>(value));
+        p = next;
+    }
+}
+
+// Печатает values[0, count) по одному на строку в конец out
+template<typename T>
+void formatRange(const T* values, size_t count, std::string& out) {
+    char buffer[64];
+    for (size_t i = 0; i < count; ++i) {
+        auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<TextType<T>>(values[i]));
+        if (error != std::errc()) {
+            throw std::runtime_error("Не удалось записать число");
+        }
+        out.append(buffer, end);
+        out.push_back('\n');
+    }
+}
+
+} // namespace text
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "paddedSlots.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Пул долгоживущих потоков. Потоки создаются один раз, а каждый вызов run()
+// только будит их, поэтому частые параллельные редукции не платят за
+// создание и завершение std::thread.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    bool pinned;
+
+    std::mutex mutex;                 // защищает поля текущего задания
+    std::condition_variable wakeUp;   // будит рабочие потоки
+    std::condition_variable finished; // будит вызывающий поток
+    std::mutex runMutex;              // run() выполняется одним вызывающим за раз
+
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobTasks = 0;
+    size_t generation = 0;
+    bool stopping = false;
+
+    // Счетчики меняются каждой задачей, поэтому у каждого своя строка кэша
+    alignas(cacheLineSize) std::atomic<size_t> nextTask{0};
+    alignas(cacheLineSize) std::atomic<size_t> doneTasks{0};
+    size_t activeWorkers = 0;         // рабочие, взявшие текущее задание
+    std::exception_ptr firstError;
+
+    // Сколько раз рабочий поток проверяет новое задание, прежде чем уснуть
+    static constexpr int spinIterations = 2000;
+
+    static bool& insideWorker() {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    static void pinToCore(std::thread& th, size_t core) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core % CPU_SETSIZE, &set);
+        pthread_setaffinity_np(th.native_handle(), sizeof(set), &set);
+#else
+        (void)th;
+        (void)core;
+#endif
+    }
+
+    // Забираем задачи текущего задания, пока они не закончатся
+    void drainTasks(const std::function<void(size_t)>& fn, size_t numTasks) {
+        for (size_t task = nextTask.fetch_add(1); task < numTasks; task = nextTask.fetch_add(1)) {
+            try {
+                fn(task);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+            doneTasks.fetch_add(1);
+        }
+    }
+
+    void workerLoop() {
+        insideWorker() = true;
+        size_t seenGeneration = 0;
+        while (true) {
+            const std::function<void(size_t)>* fn = nullptr;
+            size_t numTasks = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // Короткое ожидание без сна: следующий run() часто приходит сразу
+                for (int spin = 0; spin < spinIterations && !stopping && generation == seenGeneration; ++spin) {
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
+                wakeUp.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if (stopping) {
+                    return;
+                }
+                seenGeneration = generation;
+                fn = job;
+                numTasks = jobTasks;
+                if (!fn) {
+                    // Задание уже выполнено без нас
+                    continue;
+                }
+                ++activeWorkers;
+            }
+            drainTasks(*fn, numTasks);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --activeWorkers;
+            }
+            finished.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t numWorkers = std::thread::hardware_concurrency(), bool pinThreads = false)
+        : pinned(pinThreads) {
+        if (numWorkers == 0) {
+            numWorkers = 1;
+        }
+        workers.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; ++i) {
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+            if (pinned) {
+                pinToCore(workers.back(), i);
+            }
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& th : workers) {
+            th.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const {
+        return workers.size();
+    }
+
+    bool isPinned() const {
+        return pinned;
+    }
+
+    // Выполняет fn(task) для каждого task из [0, numTasks) и ждет завершения.
+    // Вызывающий поток тоже забирает задачи. Первое исключение пробрасывается.
+    void run(size_t numTasks, const std::function<void(size_t)>& fn) {
+        if (numTasks == 0) {
+            return;
+        }
+        // Вложенный вызов из рабочего потока выполняем на месте, иначе он
+        // ждал бы сам себя
+        if (insideWorker() || numTasks == 1) {
+            for (size_t task = 0; task < numTasks; ++task) {
+                fn(task);
+            }
+            return;
+        }
+
+        // Пул занят заданием другого потока: выполняем задачи на месте, а не
+        // ждем в очереди, чтобы свертки из разных потоков не блокировали
+        // друг друга
+        std::unique_lock<std::mutex> runLock(runMutex, std::try_to_lock);
+        if (!runLock.owns_lock()) {
+            for (size_t task = 0; task < numTasks; ++task) {
+                fn(task);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobTasks = numTasks;
+            firstError = nullptr;
+            nextTask.store(0);
+            doneTasks.store(0);
+            ++generation;
+        }
+        wakeUp.notify_all();
+
+        drainTasks(fn, numTasks);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Ждем не только задачи, но и выход рабочих из задания: иначе
+            // опоздавший поток мог бы взять задачи следующего run() со старой fn
+            finished.wait(lock, [&] { return doneTasks.load() == numTasks && activeWorkers == 0; });
+            job = nullptr;
+            error = firstError;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Общий пул процесса, размер определяется числом аппаратных потоков
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+};
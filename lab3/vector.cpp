@@ -1,365 +1,20 @@
-#include <iostream>
-#include <vector>
-#include <thread>
-#include <random>
+#include "vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <limits>
-#include <cmath>
-#include <chrono>
-#include <mutex>
-
-template<typename T>
-class Vector {
-private:
-    size_t n;
-    T* data;
-    bool isInitialized; 
-    mutable std::mutex mutex;
-
-public:
-    //конструктор
-    Vector(size_t size): n(size), data(nullptr), isInitialized(false) {
-        if (size > 0) {
-            data = new T[size]; //Выделяем память
-        } else {
-            throw std::invalid_argument("Размер должен быть положительным");
-        }
-    }
-
-    //деструктор
-    ~Vector() {
-        delete[] data;
-    }
-
-    void initializeConstant(T value) {
-        // Захватываем мьютекс
-        std::lock_guard<std::mutex> lock(mutex);
-        // Заполняем всю data значением value 
-        std::fill(data, data + n, value);
-        // Указываем, что вектор инициализирован
-        isInitialized = true;
-    }
-
-    void initializeRandom(T minValue, T maxValue) {
-        // Захватываем мьютекс
-        std::lock_guard<std::mutex> lock(mutex);
-        std::random_device rd; //источник случайных чисел
-        std::mt19937 gen(rd()); //генератор случайных чисел
-        std::uniform_real_distribution<T> dist(minValue, maxValue); // равномерное распределение чисел с плавающей точкой
-        //заполняем данные
-        for (size_t i = 0; i < n; ++i) {
-            data[i] = dist(gen);
-        }
-        isInitialized = true;
-    }
-
-    // Проверка на то инициализирован ли вектор
-    void checkInitialization() const {
-        if (!isInitialized) {
-            throw std::logic_error("Вектор не инициализирован");
-        }
-    }
-
-    void Export(const std::string& filename) const {
-        checkInitialization();
-        // Захватываем мьютекс
-        std::lock_guard<std::mutex> lock(mutex);
-        // Открываем файл
-        std::ofstream file(filename, std::ios::out);
-        // Проверяем открылся ли он
-        if (!file) {
-            throw std::ios_base::failure("Ошибка экспорта");
-        }
-        // Записываем в файл по одному элементу на строчку
-        for (size_t i = 0; i < n; ++i) {
-            file << data[i] << "\n";
-        }
-    }
-
-    void Import(const std::string& filename) {
-        std::lock_guard<std::mutex> lock(mutex);
-        std::ifstream file(filename, std::ios::in);
-        if (!file) {
-            throw std::ios_base::failure("Ошибка импорта");
-        }
-        size_t i = 0;
-        T value;
-        while (file >> value && i < n) {
-            data[i++] = value;
-        }
-        if (i < n) {
-            throw std::runtime_error("Недостаточно данных");
-        }
-        isInitialized = true;
-    }
-
-    // Поиск минимального элемента
-    std::pair<T, size_t> findMin() const {
-        checkInitialization();
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        T minValue = std::numeric_limits<T>::max();
-        size_t minIndex = 0;
-        for (size_t i = 0; i < n; ++i) {
-            if (data[i] < minValue) {
-                minValue = data[i];
-                minIndex = i;
-            }
-        }
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = endTime - startTime;
-        std::cout << "Время поиска минимума: " << elapsed.count() << " секунд" << std::endl;
-
-        return std::make_pair(minValue, minIndex);
-    }
-
-    // Поиск минимального элемента std::thread
-    std::tuple<T, size_t> findMinParallel(size_t numThreads) {
-        checkInitialization();
-
-        auto start = std::chrono::high_resolution_clock::now();
-        T minValue = data[0];
-        size_t minIndex = 0;
-
-        std::vector<std::thread> threads;
-        std::vector<T> minValues(numThreads, std::numeric_limits<T>::max());
-        std::vector<size_t> minIndexes(numThreads, 0);
-
-        // Функция для поиска минимального элемента в каждой части вектора
-        auto findMinInRange = [&](size_t threadId, size_t start, size_t end) {
-            T minValueLocal = data[start];
-            size_t minIndexLocal = start;
-
-            for (size_t i = start + 1; i < end; ++i) {
-                if (data[i] < minValueLocal) {
-                    minValueLocal = data[i];
-                    minIndexLocal = i;
-                }
-            }
-
-            minValues[threadId] = minValueLocal;
-            minIndexes[threadId] = minIndexLocal;
-        };
-
-        // Разбиение работы между потоками
-        size_t chunkSize = n / numThreads;
-        for (size_t i = 0; i < numThreads; ++i) {
-            size_t start = i * chunkSize;
-            size_t end = (i == numThreads - 1) ? n : (i + 1) * chunkSize;
-            threads.push_back(std::thread(findMinInRange, i, start, end));
-        }
-
-        // Ожидание завершения всех потоков
-        for (auto& th : threads) {
-            th.join();
-        }
-
-        // Обработка результатов
-        for (size_t i = 0; i < numThreads; ++i) {
-            if (minValues[i] < minValue) {
-                minValue = minValues[i];
-                minIndex = minIndexes[i];
-            }
-        }
-
-        auto end = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Время поиска минимума в параллельном: " << elapsed.count() << " секунд" << std::endl;
-
-        return {minValue, minIndex};
-    }
-
-    std::pair<T, size_t> findMax() const {
-        checkInitialization();
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        T maxValue = std::numeric_limits<T>::lowest();
-        size_t maxIndex = 0;
-        for (size_t i = 0; i < n; ++i) {
-            if (data[i] > maxValue) {
-                maxValue = data[i];
-                maxIndex = i;
-            }
-        }
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = endTime - startTime;
-        std::cout << "Время поиска максимума: " << elapsed.count() << " секунд" << std::endl;
-
-        return std::make_pair(maxValue, maxIndex);
-    }
-
-    std::tuple<T, size_t> findMaxParallel(size_t numThreads) {
-        checkInitialization();
-
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        T maxValue = data[0];
-        size_t maxIndex = 0;
-
-        std::vector<std::thread> threads;
-        std::vector<T> maxValues(numThreads, std::numeric_limits<T>::min());
-        std::vector<size_t> maxIndexes(numThreads, 0);
-
-        // Функция для поиска максимального элемента в каждой части вектора
-        auto findMaxInRange = [&](size_t threadId, size_t start, size_t end) {
-            T maxValueLocal = data[start];
-            size_t maxIndexLocal = start;
-
-            for (size_t i = start + 1; i < end; ++i) {
-                if (data[i] > maxValueLocal) {
-                    maxValueLocal = data[i];
-                    maxIndexLocal = i;
-                }
-            }
-
-            maxValues[threadId] = maxValueLocal;
-            maxIndexes[threadId] = maxIndexLocal;
-        };
-
-        // Разбиение работы между потоками
-        size_t chunkSize = n / numThreads;
-        for (size_t i = 0; i < numThreads; ++i) {
-            size_t start = i * chunkSize;
-            size_t end = (i == numThreads - 1) ? n : (i + 1) * chunkSize;
-            threads.push_back(std::thread(findMaxInRange, i, start, end));
-        }
-
-        // Ожидание завершения всех потоков
-        for (auto& th : threads) {
-            th.join();
-        }
-
-        // Обработка результатов
-        for (size_t i = 0; i < numThreads; ++i) {
-            if (maxValues[i] > maxValue) {
-                maxValue = maxValues[i];
-                maxIndex = maxIndexes[i];
-            }
-        }
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = endTime - startTime;
-        std::cout << "Время поиска максимума в параллельном: " << elapsed.count() << " секунд" << std::endl;
-
-        return {maxValue, maxIndex};
-    }
-
-    T calculateMean() const {
-        checkInitialization();
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        T sum = 0;
-        for (size_t i = 0; i < n; ++i) {
-            sum += data[i];
-        }
-
-        T mean = sum / static_cast<T>(n);
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = endTime - startTime;
-        std::cout << "Время вычисления среднего: " << elapsed.count() << " секунд" << std::endl;
-
-        return mean;
-    }
-
-    T calculateMeanParallel(size_t numThreads) const {
-        checkInitialization();
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        T sum = 0;
-
-        std::vector<std::thread> threads;
-        std::vector<T> allSum(numThreads);
-
-        auto calculateMeanInRange = [&](size_t threadId, size_t start, size_t end) {
-            for (size_t i = start; i < end; ++i) {
-                allSum[threadId] += data[i];
-            }
-        };
-
-        size_t chunkSize = n / numThreads;
-        for (size_t i = 0; i < numThreads; ++i) {
-            size_t start = i * chunkSize;
-            size_t end = (i == numThreads - 1) ? n : (i + 1) * chunkSize;
-            threads.push_back(std::thread(calculateMeanInRange, i, start, end));
-        }
-
-        for (auto& th : threads) {
-            th.join();
-        }
-
-        for (size_t i = 0; i < numThreads; ++i) {
-            sum += allSum[i];
-        }
-        T mean = sum / static_cast<T>(n);
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = endTime - startTime;
-        std::cout << "Время поиска среднего в параллельном: " << elapsed.count() << " секунд" << std::endl;
-
-        return mean;
-    }
-
-    T calculateSum() const {
-        checkInitialization();
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        T sum = 0;
-        for (size_t i = 0; i < n; ++i) {
-            sum += data[i];
-        }
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = endTime - startTime;
-        std::cout << "Время вычисления суммы: " << elapsed.count() << " секунд" << std::endl;
-
-        return sum;
-    }
-
-    T calculateSumParallel(size_t numThreads) const {
-        checkInitialization();
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-       T sum = 0;
-
-        std::vector<std::thread> threads;
-        std::vector<T> allSum(numThreads);
-
-        auto calculateMeanInRange = [&](size_t threadId, size_t start, size_t end) {
-            for (size_t i = start; i < end; ++i) {
-                allSum[threadId] += data[i];
-            }
-        };
-
-        size_t chunkSize = n / numThreads;
-        for (size_t i = 0; i < numThreads; ++i) {
-            size_t start = i * chunkSize;
-            size_t end = (i == numThreads - 1) ? n : (i + 1) * chunkSize;
-            threads.push_back(std::thread(calculateMeanInRange, i, start, end));
-        }
-
-        for (auto& th : threads) {
-            th.join();
-        }
-
-        for (size_t i = 0; i < numThreads; ++i) {
-            sum += allSum[i];
-        }
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = endTime - startTime;
-        std::cout << "Время вычисления суммы в параллельном: " << elapsed.count() << " секунд" << std::endl;
-
-        return sum;
-    }
-};
+#include <vector>
 
 int main() {
     try {
+        std::cout << "Набор инструкций: " << simd::isaName(simd::detectIsa()) << std::endl;
+
         Vector<double> vec(10000000);
-        vec.initializeRandom(0.0, 5.0);
+        vec.initializeRandom(0.0, 5.0, 42, 10);
 
         auto [minValue, minIndex] = vec.findMin();
         std::cout << "Минимум: " << minValue << ", индекс: " << minIndex << std::endl;
@@ -385,6 +40,142 @@ int main() {
         double sumParallel = vec.calculateSumParallel(10);
         std::cout << "Сумма: " << sumParallel << std::endl;
 
+        // Сумма не зависит от расписания; время операций измеряет benchmark.cpp
+        for (auto schedule : {scheduler::Schedule::Static, scheduler::Schedule::Dynamic,
+                              scheduler::Schedule::Guided, scheduler::Schedule::WorkStealing}) {
+            double sumScheduled = vec.calculateSumParallel(10, schedule);
+            std::cout << "Сумма (" << scheduler::scheduleName(schedule) << "): " << sumScheduled << std::endl;
+        }
+
+        // Воспроизводимая сумма побитово одинакова при любом числе потоков
+        double deterministic1 = vec.calculateSumDeterministic(1);
+        double deterministic10 = vec.calculateSumDeterministic(10, scheduler::Schedule::WorkStealing);
+        std::cout.precision(17);
+        std::cout << "Воспроизводимая сумма: " << deterministic1 << " и " << deterministic10
+                  << (deterministic1 == deterministic10 ? " (совпадают)" : " (различаются)") << std::endl;
+        std::cout.precision(6);
+        try {
+            vec.calculateSumDeterministic(0);
+            std::cout << "Воспроизводимая сумма в 0 потоков посчитана" << std::endl;
+        } catch (const std::invalid_argument& e) {
+            std::cout << "Воспроизводимая сумма в 0 потоков: " << e.what() << std::endl;
+        }
+
+        Statistics<double> stats = vec.describeParallel(10);
+        std::cout << "Минимум: " << stats.min << ", индекс: " << stats.minIndex
+                  << ", максимум: " << stats.max << ", индекс: " << stats.maxIndex << std::endl;
+        std::cout << "Сумма: " << stats.sum << ", среднее: " << stats.mean
+                  << ", дисперсия: " << stats.variance() << std::endl;
+
+        std::cout << "Медиана: " << vec.quantileParallel(0.5, 10)
+                  << ", p99: " << vec.quantileParallel(0.99, 10) << std::endl;
+
+        // Ранги хвостов ищутся в корзине, открытой с одной стороны, без копии
+        // всего вектора; результат сверяется с nth_element по копии
+        size_t copiesBefore = order::fullCopySelections().load();
+        size_t tailRank = vec.size() - vec.size() / 100;
+        double tail = vec.nthElementParallel(tailRank, 10);
+        double head = vec.nthElementParallel(vec.size() / 100, 10);
+        bool copied = order::fullCopySelections().load() != copiesBefore;
+        auto copySnapshot = vec.snapshot();
+        std::vector<double> copy(copySnapshot.data(), copySnapshot.data() + vec.size());
+        std::nth_element(copy.begin(), copy.begin() + tailRank, copy.end());
+        bool tailMatches = copy[tailRank] == tail;
+        std::nth_element(copy.begin(), copy.begin() + vec.size() / 100, copy.end());
+        bool headMatches = copy[vec.size() / 100] == head;
+        std::cout << "Ранг p99: " << tail << ", ранг p1: " << head
+                  << (tailMatches && headMatches ? " (совпадают с nth_element)" : " (не совпадают с nth_element)")
+                  << (copied ? ", через копию вектора" : ", без копии вектора") << std::endl;
+
+        // Все элементы +inf: минимум - сам элемент 0, а не numeric_limits::max()
+        {
+            Vector<double> infinite(1000);
+            infinite.initializeConstant(std::numeric_limits<double>::infinity());
+            auto [infMin, infMinIndex] = infinite.findMin();
+            auto [infMinParallel, infMinParallelIndex] = infinite.findMinParallel(10);
+            std::cout << "Минимум из +inf: " << infMin << " [" << infMinIndex << "], параллельно: " << infMinParallel
+                      << " [" << infMinParallelIndex << "]" << std::endl;
+        }
+
+        // Статистика окна и каждого десятого элемента без копирования
+        VectorView<double> window = vec.slice(1000, 2000);
+        std::cout << "Среднее окна [1000, 2000): " << window.calculateMean()
+                  << ", среднее каждого 10-го: " << vec.strided(10).calculateMeanParallel(10) << std::endl;
+
+        // После точечных изменений индекс пересчитывает только измененные блоки
+        vec.enableIndex();
+        vec.set(123, -1.0);
+        auto [indexedMin, indexedMinIndex] = vec.findMin();
+        std::cout << "Минимум после изменения: " << indexedMin << ", индекс: " << indexedMinIndex << std::endl;
+        std::cout << "Сумма первой половины: " << vec.calculateSum(0, vec.size() / 2) << std::endl;
+
+        // Снимок не меняется при записи в вектор: правка идет в копию
+        auto snapshot = vec.snapshot();
+        vec.set(123, 10.0);
+        std::cout << "Элемент 123 в снимке: " << snapshot.data()[123] << ", в векторе: " << vec.view()[123] << std::endl;
+
+        // Заголовок с count, при котором count * sizeof(double) переполняется:
+        // импорт должен отказать, а не читать за концом отображения
+        {
+            const std::string checkName = "vector_check.bin";
+            Vector<double> small(1000);
+            small.initializeConstant(1.0);
+            small.ExportBinary(checkName);
+            uint64_t hugeCount = (uint64_t(1) << 61) + 1;
+            std::fstream file(checkName, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(offsetof(binary::BinaryHeader, count));
+            file.write(reinterpret_cast<const char*>(&hugeCount), sizeof(hugeCount));
+            file.close();
+            try {
+                small.ImportBinary(checkName);
+                std::cout << "Файл с завышенным count прочитан" << std::endl;
+            } catch (const std::runtime_error& e) {
+                std::cout << "Файл с завышенным count отклонен: " << e.what() << std::endl;
+            }
+            std::remove(checkName.c_str());
+        }
+
+        // Файл машины с другим порядком байт: заголовок и элементы
+        // переставлены вручную, контрольная сумма посчитана по байтам файла
+        {
+            const std::string swappedName = "vector_swapped.bin";
+            const size_t count = 1001;
+            Vector<double> original(count);
+            original.initializeRandom(-1.0, 1.0, 7, 1);
+            auto originalSnapshot = original.snapshot();
+            std::vector<double> payload(originalSnapshot.data(), originalSnapshot.data() + count);
+            for (double& value : payload) {
+                value = binary::byteSwapValue(value);
+            }
+            binary::BinaryHeader header{};
+            std::memcpy(header.magic, binary::magic, sizeof(header.magic));
+            header.version = binary::byteSwap(binary::currentVersion);
+            header.endian = binary::byteSwap(binary::endianMarker);
+            header.typeTag = binary::byteSwap(static_cast<uint32_t>(binary::typeTag<double>()));
+            header.elementSize = binary::byteSwap(static_cast<uint32_t>(sizeof(double)));
+            header.count = binary::byteSwap(static_cast<uint64_t>(count));
+            header.checksum = binary::byteSwap(binary::checksum64(payload.data(), count * sizeof(double), 0));
+            std::ofstream file(swappedName, std::ios::out | std::ios::binary);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(count * sizeof(double)));
+            file.close();
+
+            Vector<double> imported(count);
+            imported.ImportBinary(swappedName);
+            auto importedSnapshot = imported.snapshot();
+            bool same = std::equal(importedSnapshot.data(), importedSnapshot.data() + count, originalSnapshot.data());
+            std::cout << "Файл с другим порядком байт: "
+                      << (same ? "прочитан, элементы совпадают" : "элементы не совпадают") << std::endl;
+            std::remove(swappedName.c_str());
+        }
+
+        // 16-битные элементы: сумма копится в 64 бита (int16) и в double (half)
+        Vector<int16_t> small(1000000);
+        small.initializeConstant(30000);
+        Vector<numeric::half> halves(1000000);
+        halves.initializeRandom(numeric::half(0.0f), numeric::half(1.0f), 42, 10);
+        std::cout << "Сумма int16: " << small.calculateSum() << ", среднее half: " << halves.calculateMean() << std::endl;
+
     } catch (const std::exception& e) {
         std::cerr << "Ошибка: " << e.what() << std::endl;
     }
@@ -0,0 +1,1080 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include <thread>
+#include <random>
+#include <fstream>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+#include "allocators.h"
+#include "binaryFormat.h"
+#include "executor.h"
+#include "expression.h"
+#include "orderStatistics.h"
+#include "paddedSlots.h"
+#include "random.h"
+#include "scheduler.h"
+#include "sharedMemory.h"
+#include "simd.h"
+#include "statistics.h"
+#include "summaryIndex.h"
+#include "textFormat.h"
+#include "threadPool.h"
+#include "versionedBuffer.h"
+#include "vectorView.h"
+
+// Allocator - политика выделения буфера (см. allocators.h): по умолчанию
+// выравнивание по 64 байтам, есть большие страницы, NUMA и пул буферов.
+//
+// Данные хранятся в VersionedBuffer (см. versionedBuffer.h), поэтому
+// свертки и экспорт из разных потоков не блокируют друг друга и писателей:
+// инициализация, импорт, parallelTransform и sortParallel заполняют новый
+// буфер и публикуют его целиком, а set/setRange/transformRange правят
+// текущий буфер под счетчиком последовательности. Писатели выполняются
+// по одному. Запись целиком временно держит в памяти два буфера.
+template<typename T, typename Allocator = allocators::AlignedAllocator>
+class Vector {
+public:
+    using Buffer = VersionedBuffer<T, Allocator>;
+    using Version = typename Buffer::Version;
+    // Неизменный снимок данных для потоков мониторинга (snapshot())
+    using Snapshot = typename Buffer::Snapshot;
+    // Тип сумм (numeric.h): целые копятся в 64 бита, float, half и
+    // bfloat16 - в double, поэтому сумма не переполняется и не теряет точность
+    using Sum = numeric::Accumulator<T>;
+
+private:
+    size_t n;
+    Buffer buffer;
+    std::shared_ptr<SummaryIndex<T>> index; // необязательный индекс сводок (enableIndex), atomic_load/atomic_store
+
+    // Минимальная часть для параллельного ввода-вывода в элементах
+    static constexpr size_t minIoChunk = size_t(1) << 16;
+    // Сколько элементов текстового экспорта форматируется в памяти за раз
+    static constexpr size_t textExportWindow = size_t(1) << 22;
+    // Ключ выборок для сортировки и поиска k-го элемента
+    static constexpr uint64_t orderSampleSeed = 0x0DDBA11;
+    // Размер выборки для поиска k-го элемента и начальный запас рангов вокруг
+    // оценки (около 4 стандартных отклонений ранга в выборке)
+    static constexpr size_t selectionSampleSize = size_t(1) << 14;
+    static constexpr size_t selectionMargin = 512;
+    // Элементов выборки на корзину сортировки и размер, ниже которого
+    // сортировка выполняется в одном потоке
+    static constexpr size_t sortOversampling = 64;
+    static constexpr size_t parallelSortThreshold = size_t(1) << 15;
+
+public:
+    //конструктор. Память выделяется первой инициализацией или импортом
+    Vector(size_t size): n(size) {
+        if (size == 0) {
+            throw std::invalid_argument("Размер должен быть положительным");
+        }
+    }
+
+    // Перемещение забирает буфер и индекс; исходный вектор остается пустым
+    // и неинициализированным. Перемещать вектор, с которым работают другие
+    // потоки, нельзя.
+    Vector(Vector&& other) noexcept : n(0) {
+        takeFrom(other);
+    }
+
+    Vector& operator=(Vector&& other) noexcept {
+        if (this != &other) {
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    Vector(const Vector&) = delete;
+    Vector& operator=(const Vector&) = delete;
+
+private:
+    void takeFrom(Vector& other) {
+        buffer.takeFrom(other.buffer);
+        n = std::exchange(other.n, 0);
+        std::atomic_store(&index, std::atomic_exchange(&other.index, std::shared_ptr<SummaryIndex<T>>()));
+    }
+
+public:
+    // Невладеющие представления для сверток без копирования (см. vectorView.h).
+    // Представление действительно до следующей записи целиком; потокам,
+    // которые читают параллельно с записью, нужен snapshot().
+    VectorView<T> view() const {
+        checkInitialization();
+        return VectorView<T>(buffer.acquire()->data, n);
+    }
+
+    // Снимок текущих данных: не меняется и не освобождается, пока существует,
+    // и не мешает писателям (правки на месте на время снимка идут в копию)
+    Snapshot snapshot() const {
+        return buffer.pinInitialized();
+    }
+
+    operator VectorView<T>() const {
+        return view();
+    }
+
+    // Элементы [lo, hi)
+    VectorView<T> slice(size_t lo, size_t hi) const {
+        return view().slice(lo, hi);
+    }
+
+    // Каждый every-й элемент, начиная с первого
+    VectorView<T> strided(size_t every) const {
+        return view().strided(every);
+    }
+
+    void initializeConstant(T value) {
+        // Захватываем блокировку писателей
+        auto lock = buffer.lockWriters();
+        // Заполняем новый буфер значением value и публикуем его
+        auto version = buffer.create(n);
+        std::fill(version->data, version->data + n, value);
+        buffer.publish(std::move(version));
+    }
+
+    void initializeRandom(T minValue, T maxValue) {
+        // Захватываем блокировку писателей
+        auto lock = buffer.lockWriters();
+        auto version = buffer.create(n);
+        T* data = version->data;
+        std::random_device rd; //источник случайных чисел
+        std::mt19937 gen(rd()); //генератор случайных чисел
+        // равномерное распределение: вещественное или целочисленное в зависимости от T;
+        // байтовые целые и 16-битные вещественные разыгрываются в более широком типе
+        using Value = std::conditional_t<std::is_integral_v<T> && sizeof(T) < sizeof(int),
+            std::conditional_t<std::is_signed_v<T>, int, unsigned>,
+            std::conditional_t<numeric::isReducedFloat<T>, float, T>>;
+        using Distribution = std::conditional_t<std::is_integral_v<T>,
+            std::uniform_int_distribution<Value>, std::uniform_real_distribution<Value>>;
+        Distribution dist(static_cast<Value>(minValue), static_cast<Value>(maxValue));
+        //заполняем данные
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = static_cast<T>(dist(gen));
+        }
+        buffer.publish(std::move(version));
+    }
+
+    // Параллельное заполнение счетчиковым генератором Philox: результат
+    // зависит только от seed и не зависит от числа потоков. Каждая часть
+    // впервые записывается потоком пула, поэтому на NUMA-системах ее страницы
+    // выделяются на узле этого потока (first touch).
+    void initializeRandom(T minValue, T maxValue, uint64_t seed, size_t numThreads) {
+        auto lock = buffer.lockWriters();
+        auto version = buffer.create(n);
+        T* data = version->data;
+        Philox4x32 generator(seed);
+
+        auto fillRange = [&](size_t, size_t start, size_t end) {
+            for (size_t i = start; i < end; ++i) {
+                data[i] = uniformFromBits(generator.bits(i), minValue, maxValue);
+            }
+        };
+
+        runChunks(numThreads, fillRange);
+        buffer.publish(std::move(version));
+    }
+
+    // Делит [from, to) на numThreads равных частей и обрабатывает их в общем
+    // пуле потоков: fn(номер части, начало, конец)
+    template<typename F>
+    void runChunksInRange(size_t from, size_t to, size_t numThreads, F&& fn) const {
+        auto bounds = scheduler::partition(from, to, numThreads, scheduler::Schedule::Static);
+        runPartition(bounds, numThreads, scheduler::Schedule::Static, fn);
+    }
+
+    // Обрабатывает готовое разбиение по расписанию: fn(номер части, начало, конец)
+    template<typename F>
+    void runPartition(const std::vector<size_t>& bounds, size_t numThreads, scheduler::Schedule schedule, F&& fn) const {
+        scheduler::run(bounds.size() - 1, numThreads, schedule, [&](size_t i) {
+            if (bounds[i] < bounds[i + 1]) {
+                fn(i, bounds[i], bounds[i + 1]);
+            }
+        });
+    }
+
+    template<typename F>
+    void runChunks(size_t numThreads, F&& fn) const {
+        runChunksInRange(0, n, numThreads, std::forward<F>(fn));
+    }
+
+    // Число частей для ввода-вывода: по одной на поток пула, но не мельче minIoChunk
+    size_t ioChunks(size_t count) const {
+        return std::max<size_t>(1, std::min(ThreadPool::instance().size(), count / minIoChunk));
+    }
+
+    // Обобщенная параллельная свертка. Вектор делится на части по расписанию
+    // options.schedule (см. scheduler.h), для каждой
+    // части вызывается mapFn(указатель на начало, длина, индекс начала) -> R,
+    // затем результаты частей сворачиваются combineFn слева направо в порядке
+    // частей, начиная с init. combineFn должна быть ассоциативной, а init -
+    // нейтральным элементом. Если во время свертки данные правились на месте,
+    // она повторяется, поэтому mapFn и combineFn не должны иметь побочных
+    // эффектов.
+    template<typename R, typename MapFn, typename CombineFn>
+    R parallelReduce(R init, MapFn&& mapFn, CombineFn&& combineFn, ReduceOptions options = {}) const {
+        // Непрерывное представление передает mapFn части целиком
+        return buffer.read([&](const Version& version) {
+            return VectorView<T>(version.data, n).parallelReduce(init, mapFn, combineFn, options);
+        });
+    }
+
+    // Свертка значений transformFn(x) по всем элементам. Внутри части используются
+    // четыре независимых аккумулятора, чтобы цикл не упирался в задержку combineFn.
+    template<typename R, typename TransformFn, typename CombineFn>
+    R parallelTransformReduce(R init, TransformFn&& transformFn, CombineFn&& combineFn, ReduceOptions options = {}) const {
+        return parallelReduce(
+            init,
+            [&](const T* chunk, size_t length, size_t) {
+                R acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+                size_t i = 0;
+                for (; i + 4 <= length; i += 4) {
+                    acc0 = combineFn(acc0, transformFn(chunk[i]));
+                    acc1 = combineFn(acc1, transformFn(chunk[i + 1]));
+                    acc2 = combineFn(acc2, transformFn(chunk[i + 2]));
+                    acc3 = combineFn(acc3, transformFn(chunk[i + 3]));
+                }
+                for (; i < length; ++i) {
+                    acc0 = combineFn(acc0, transformFn(chunk[i]));
+                }
+                return combineFn(combineFn(acc0, acc1), combineFn(acc2, acc3));
+            },
+            combineFn,
+            options);
+    }
+
+    // Записывает в вектор значение выражения (expression.h) одного с ним
+    // размера, например vec.assign((a - b) * w). Выражение вычисляется за
+    // один параллельный проход в новый буфер, поэтому вектор может быть и
+    // своим операндом: a.assign(a * 2.0).
+    template<typename E, typename = std::enable_if_t<expr::isOperand<E>>>
+    void assign(const E& e, ReduceOptions options = {}) {
+        auto node = expr::operand(e);
+        if (node.size() != n) {
+            throw std::invalid_argument("Размеры векторов не совпадают");
+        }
+        auto lock = buffer.lockWriters();
+        auto version = buffer.create(n);
+        expr::evaluateInto(node, version->data, options);
+        buffer.publish(std::move(version));
+    }
+
+    // vec = выражение; присваивание вектора вектору по-прежнему запрещено
+    template<typename E, typename = std::enable_if_t<expr::isOperand<E> && !std::is_same_v<E, Vector>>>
+    Vector& operator=(const E& e) {
+        assign(e);
+        return *this;
+    }
+
+    // Параллельное изменение всех элементов: x = fn(x). Результат пишется в
+    // новый буфер за тот же проход и публикуется целиком.
+    template<typename Fn>
+    void parallelTransform(Fn&& fn, ReduceOptions options = {}) {
+        checkInitialization();
+        auto lock = buffer.lockWriters();
+        auto source = buffer.acquire();
+        auto version = buffer.create(n);
+        auto bounds = scheduler::partition(0, n, options.numThreads, options.schedule, options.grain);
+        runPartition(bounds, options.numThreads, options.schedule, [&](size_t, size_t start, size_t end) {
+            for (size_t i = start; i < end; ++i) {
+                version->data[i] = fn(source->data[i]);
+            }
+        });
+        buffer.publish(std::move(version));
+    }
+
+    // Параллельный обход всех элементов снимка данных: fn(значение, индекс)
+    template<typename Fn>
+    void parallelForEach(Fn&& fn, ReduceOptions options = {}) const {
+        Snapshot snapshot = buffer.pinInitialized();
+        const T* data = snapshot.data();
+        auto bounds = scheduler::partition(0, n, options.numThreads, options.schedule, options.grain);
+        runPartition(bounds, options.numThreads, options.schedule, [&](size_t, size_t start, size_t end) {
+            for (size_t i = start; i < end; ++i) {
+                fn(data[i], i);
+            }
+        });
+    }
+
+    // Сумма всех элементов по частям векторными ядрами
+    Sum parallelSum(size_t numThreads, scheduler::Schedule schedule) const {
+        return parallelReduce(
+            Sum(0),
+            [](const T* chunk, size_t length, size_t) { return simd::sum(chunk, length); },
+            std::plus<Sum>(),
+            {numThreads, schedule});
+    }
+
+    // Проверка на то инициализирован ли вектор
+    void checkInitialization() const {
+        if (!buffer.acquire()) {
+            throw std::logic_error("Вектор не инициализирован");
+        }
+    }
+
+    size_t size() const {
+        return n;
+    }
+
+    // Проверка диапазона [lo, hi) для запросов и изменений части вектора
+    void checkRange(size_t lo, size_t hi) const {
+        if (lo >= hi || hi > n) {
+            throw std::out_of_range("Неверный диапазон [" + std::to_string(lo) + ", " + std::to_string(hi) + ")");
+        }
+    }
+
+    // Включает индекс сводок по блокам (см. summaryIndex.h): после изменений
+    // через set/setRange/transformRange запросы минимума, максимума и суммы
+    // пересчитывают только измененные блоки, а не весь вектор
+    // Индекс строится по версии буфера: после записи целиком он
+    // перестраивается при следующем запросе
+    void enableIndex(size_t blockSize = SummaryIndex<T>::defaultBlockSize) {
+        auto lock = buffer.lockWriters();
+        std::atomic_store(&index, std::make_shared<SummaryIndex<T>>(n, blockSize));
+    }
+
+    void disableIndex() {
+        auto lock = buffer.lockWriters();
+        std::atomic_store(&index, std::shared_ptr<SummaryIndex<T>>());
+    }
+
+    bool hasIndex() const {
+        return std::atomic_load(&index) != nullptr;
+    }
+
+private:
+    // Правка элементов [lo, hi) текущего буфера: fn(data). Блоки индекса
+    // помечаются до окончания правки, чтобы свертка, прочитавшая индекс
+    // между ними, повторилась.
+    template<typename Fn>
+    void editRange(size_t lo, size_t hi, Fn&& fn) {
+        checkInitialization();
+        checkRange(lo, hi);
+        auto lock = buffer.lockWriters();
+        auto summaryIndex = std::atomic_load(&index);
+        buffer.edit([&](Version& version) {
+            fn(version.data);
+            if (summaryIndex) {
+                summaryIndex->markDirty(lo, hi);
+            }
+        });
+    }
+
+public:
+    // Изменение одного элемента
+    void set(size_t i, T value) {
+        editRange(i, i + 1, [&](T* data) {
+            data[i] = value;
+        });
+    }
+
+    // Заполнение элементов [lo, hi) значением value
+    void setRange(size_t lo, size_t hi, T value) {
+        editRange(lo, hi, [&](T* data) {
+            std::fill(data + lo, data + hi, value);
+        });
+    }
+
+    // Изменение элементов [lo, hi) на месте: x = fn(x)
+    template<typename Fn>
+    void transformRange(size_t lo, size_t hi, Fn&& fn) {
+        editRange(lo, hi, [&](T* data) {
+            for (size_t i = lo; i < hi; ++i) {
+                data[i] = fn(data[i]);
+            }
+        });
+    }
+
+    // Сводка элементов [lo, hi): по индексу, если он включен, иначе проходом
+    BlockSummary<T> summarize(size_t lo, size_t hi) const {
+        checkInitialization();
+        checkRange(lo, hi);
+        auto summaryIndex = std::atomic_load(&index);
+        return buffer.read([&](const Version& version) {
+            if (summaryIndex) {
+                return summaryIndex->query(version.data, version.id, lo, hi);
+            }
+            return summarizeRange(version.data + lo, hi - lo, lo);
+        });
+    }
+
+    void Export(const std::string& filename) const {
+        // Закрепляем снимок: запись во время экспорта его не меняет
+        Snapshot snapshot = buffer.pinInitialized();
+        const T* data = snapshot.data();
+        // Открываем файл
+        std::ofstream file(filename, std::ios::out | std::ios::binary);
+        // Проверяем открылся ли он
+        if (!file) {
+            throw std::ios_base::failure("Ошибка экспорта");
+        }
+        // Форматируем окно элементов параллельно по частям (по одному элементу
+        // на строчку) и записываем части по порядку
+        for (size_t from = 0; from < n; from += textExportWindow) {
+            size_t to = std::min(n, from + textExportWindow);
+            size_t numChunks = ioChunks(to - from);
+            PaddedSlots<std::string> parts(numChunks);
+            runChunksInRange(from, to, numChunks, [&](size_t chunk, size_t start, size_t end) {
+                parts[chunk].reserve((end - start) * 12);
+                text::formatRange(data + start, end - start, parts[chunk]);
+            });
+            parts.forEach([&](const std::string& part) {
+                file.write(part.data(), static_cast<std::streamsize>(part.size()));
+            });
+        }
+        if (!file) {
+            throw std::ios_base::failure("Ошибка экспорта");
+        }
+    }
+
+    // Файл разбирается без блокировки, писатели ждут только копирования
+    // в новый буфер
+    void Import(const std::string& filename) {
+        binary::MappedFile file(filename);
+
+        // Делим файл по пробелам на части и разбираем их параллельно
+        size_t numParts = std::max<size_t>(1, std::min(ThreadPool::instance().size(), file.size() / minIoChunk));
+        auto bounds = text::splitAtSpaces(file.bytes(), file.bytes() + file.size(), numParts);
+        // push_back постоянно меняет поля вектора, поэтому векторы частей разнесены по строкам кэша
+        PaddedSlots<std::vector<T>> parsed(numParts);
+        ThreadPool::instance().run(numParts, [&](size_t part) {
+            text::parseRange(bounds[part], bounds[part + 1], parsed[part]);
+        });
+
+        // Раскладываем разобранные части по своим местам, лишние значения отбрасываем
+        std::vector<size_t> offsets(numParts + 1, 0);
+        for (size_t part = 0; part < numParts; ++part) {
+            offsets[part + 1] = offsets[part] + parsed[part].size();
+        }
+        if (offsets[numParts] < n) {
+            throw std::runtime_error("Недостаточно данных");
+        }
+        auto lock = buffer.lockWriters();
+        auto version = buffer.create(n);
+        ThreadPool::instance().run(numParts, [&](size_t part) {
+            size_t start = std::min(offsets[part], n);
+            size_t end = std::min(offsets[part + 1], n);
+            std::copy(parsed[part].begin(), parsed[part].begin() + (end - start), version->data + start);
+        });
+        buffer.publish(std::move(version));
+    }
+
+    // Экспорт в двоичный формат (см. binaryFormat.h): заголовок и данные как есть
+    void ExportBinary(const std::string& filename) const {
+        static_assert(binary::typeTag<T>() != binary::Unknown, "Тип не поддерживается двоичным форматом");
+        Snapshot snapshot = buffer.pinInitialized();
+        const T* data = snapshot.data();
+
+        binary::BinaryHeader header{};
+        std::memcpy(header.magic, binary::magic, sizeof(header.magic));
+        header.version = binary::currentVersion;
+        header.endian = binary::endianMarker;
+        header.typeTag = binary::typeTag<T>();
+        header.elementSize = sizeof(T);
+        header.count = n;
+        header.checksum = binary::checksumParallel(data, n * sizeof(T), ioChunks(n));
+
+        std::ofstream file(filename, std::ios::out | std::ios::binary);
+        if (!file) {
+            throw std::ios_base::failure("Ошибка экспорта");
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(n * sizeof(T)));
+        if (!file) {
+            throw std::ios_base::failure("Ошибка экспорта");
+        }
+    }
+
+    // Импорт из двоичного формата через mmap. В режиме Copy страницы файла
+    // параллельно копируются в буфер вектора, в режиме Adopt буфер заменяется
+    // самими отображенными страницами (если порядок байт файла совпадает с
+    // порядком байт машины, иначе выполняется копирование с перестановкой).
+    // Заголовок и контрольная сумма проверяются без блокировки писателей.
+    void ImportBinary(const std::string& filename, binary::ImportMode mode = binary::ImportMode::Copy) {
+        static_assert(binary::typeTag<T>() != binary::Unknown, "Тип не поддерживается двоичным форматом");
+        binary::MappedFile file(filename);
+        if (file.size() < sizeof(binary::BinaryHeader)) {
+            throw std::runtime_error("Файл короче заголовка");
+        }
+        binary::BinaryHeader header;
+        std::memcpy(&header, file.bytes(), sizeof(header));
+        bool swapped = binary::validateHeader<T>(header, file.size());
+        uint64_t count = swapped ? binary::byteSwap(header.count) : header.count;
+        uint64_t checksum = swapped ? binary::byteSwap(header.checksum) : header.checksum;
+        if (count < n) {
+            throw std::runtime_error("Недостаточно данных");
+        }
+
+        const char* payload = file.bytes() + sizeof(header);
+        if (binary::checksumParallel(payload, count * sizeof(T), ioChunks(count)) != checksum) {
+            throw std::runtime_error("Контрольная сумма не совпадает");
+        }
+
+        auto lock = buffer.lockWriters();
+        if (mode == binary::ImportMode::Adopt && !swapped) {
+            auto mapping = std::make_shared<binary::MappedFile>(std::move(file));
+            T* data = reinterpret_cast<T*>(mapping->bytes() + sizeof(header));
+            buffer.publish(buffer.adopt(std::move(mapping), data, n, false));
+        } else {
+            auto version = buffer.create(n);
+            T* data = version->data;
+            const T* values = reinterpret_cast<const T*>(payload);
+            runChunks(ioChunks(n), [&](size_t, size_t start, size_t end) {
+                if (swapped) {
+                    for (size_t i = start; i < end; ++i) {
+                        data[i] = binary::byteSwapValue(values[i]);
+                    }
+                } else {
+                    std::memcpy(data + start, values + start, (end - start) * sizeof(T));
+                }
+            });
+            buffer.publish(std::move(version));
+        }
+    }
+
+    // Копия данных в новый сегмент разделяемой памяти name (см. sharedMemory.h),
+    // к которому подключаются другие процессы и рабочие summarizeSharded
+    void ExportShared(const std::string& name, size_t maxWorkers = 64) const {
+        Snapshot snapshot = buffer.pinInitialized();
+        const T* data = snapshot.data();
+        auto shared = shm::SharedVector<T>::create(name, n, maxWorkers);
+        T* target = shared.mutableData();
+        runChunks(ioChunks(n), [&](size_t, size_t start, size_t end) {
+            std::memcpy(target + start, data + start, (end - start) * sizeof(T));
+        });
+    }
+
+    // Подключение к сегменту name только для чтения без копирования: буфер
+    // вектора - сами страницы сегмента. Правки через set/setRange/transformRange
+    // копируют данные в собственный буфер, сегмент не меняется.
+    void ImportShared(const std::string& name) {
+        auto shared = std::make_shared<shm::SharedVector<T>>(shm::SharedVector<T>::attach(name));
+        if (shared->size() < n) {
+            throw std::runtime_error("Недостаточно данных");
+        }
+        T* data = const_cast<T*>(shared->data());
+        auto lock = buffer.lockWriters();
+        buffer.publish(buffer.adopt(std::move(shared), data, n, true));
+    }
+
+    // Поиск минимального элемента
+    std::pair<T, size_t> findMin() const {
+        checkInitialization();
+        if (hasIndex()) {
+            return findMin(0, n);
+        }
+
+        auto [minValue, minIndex] = buffer.read([&](const Version& version) {
+            return simd::argMin(version.data, n);
+        });
+
+        return std::make_pair(minValue, minIndex);
+    }
+
+    // Минимум среди элементов [lo, hi), индекс считается от начала вектора
+    std::pair<T, size_t> findMin(size_t lo, size_t hi) const {
+        BlockSummary<T> summary = summarize(lo, hi);
+        return std::make_pair(summary.min, summary.minIndex);
+    }
+
+    // Поиск минимального элемента в пуле потоков
+    std::tuple<T, size_t> findMinParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        // Свертка начинается с элемента 0 того же буфера (см. VectorView::findMin)
+        return buffer.read([&](const Version& version) {
+            return VectorView<T>(version.data, n).findMinParallel(numThreads, schedule);
+        });
+    }
+
+    std::pair<T, size_t> findMax() const {
+        checkInitialization();
+        if (hasIndex()) {
+            return findMax(0, n);
+        }
+
+        auto [maxValue, maxIndex] = buffer.read([&](const Version& version) {
+            return simd::argMax(version.data, n);
+        });
+
+        return std::make_pair(maxValue, maxIndex);
+    }
+
+    std::pair<T, size_t> findMax(size_t lo, size_t hi) const {
+        BlockSummary<T> summary = summarize(lo, hi);
+        return std::make_pair(summary.max, summary.maxIndex);
+    }
+
+    std::tuple<T, size_t> findMaxParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        return buffer.read([&](const Version& version) {
+            return VectorView<T>(version.data, n).findMaxParallel(numThreads, schedule);
+        });
+    }
+
+    // Среднее всегда вещественное: для целых T деление не усекается
+    double calculateMean() const {
+        checkInitialization();
+
+        Sum sum = calculateSum();
+
+        double mean = static_cast<double>(sum) / static_cast<double>(n);
+
+        return mean;
+    }
+
+    double calculateMeanParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+
+        Sum sum = parallelSum(numThreads, schedule);
+        double mean = static_cast<double>(sum) / static_cast<double>(n);
+
+        return mean;
+    }
+
+    Sum calculateSum() const {
+        checkInitialization();
+        if (hasIndex()) {
+            return calculateSum(0, n);
+        }
+
+        Sum sum = buffer.read([&](const Version& version) {
+            return simd::sum(version.data, n);
+        });
+
+        return sum;
+    }
+
+    Sum calculateSum(size_t lo, size_t hi) const {
+        return summarize(lo, hi).sum;
+    }
+
+    Sum calculateSumParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+
+        Sum sum = parallelSum(numThreads, schedule);
+
+        return sum;
+    }
+
+    // Сумма, побитово одинаковая при любом числе потоков и расписании
+    // (см. VectorView::calculateSumDeterministic). Для целых T совпадает с
+    // calculateSum(); сверх быстрой суммы добавляется только проход по
+    // суммам блоков (один элемент на deterministicBlockSize).
+    Sum calculateSumDeterministic(size_t numThreads = ThreadPool::instance().size(),
+                                  scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        return buffer.read([&](const Version& version) {
+            return VectorView<T>(version.data, n).calculateSumDeterministic(numThreads, schedule);
+        });
+    }
+
+    double calculateMeanDeterministic(size_t numThreads = ThreadPool::instance().size(),
+                                      scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        return static_cast<double>(calculateSumDeterministic(numThreads, schedule)) / static_cast<double>(n);
+    }
+
+    // Минимум, максимум, сумма, среднее и дисперсия за один проход по памяти
+    Statistics<T> describe() const {
+        checkInitialization();
+
+        Statistics<T> stats = buffer.read([&](const Version& version) {
+            return describeRange(version.data, n, 0);
+        });
+
+        return stats;
+    }
+
+    Statistics<T> describeParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+
+        // Части объединяются по порядку, поэтому индексы совпадают с describe()
+        Statistics<T> stats = parallelReduce(
+            Statistics<T>(),
+            [](const T* chunk, size_t length, size_t offset) {
+                return describeRange(chunk, length, offset);
+            },
+            [](Statistics<T> a, const Statistics<T>& b) {
+                a.merge(b);
+                return a;
+            },
+            {numThreads, schedule});
+
+        return stats;
+    }
+
+    // Количество элементов больше threshold
+    size_t countAboveParallel(T threshold, size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        return parallelTransformReduce(
+            size_t(0),
+            [threshold](T value) { return static_cast<size_t>(value > threshold); },
+            std::plus<size_t>(),
+            {numThreads, schedule});
+    }
+
+    // Евклидова норма вектора
+    double normL2Parallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        double squares = parallelTransformReduce(
+            0.0,
+            [](T value) { return static_cast<double>(value) * static_cast<double>(value); },
+            std::plus<double>(),
+            {numThreads, schedule});
+        return std::sqrt(squares);
+    }
+
+    // Скалярное произведение с вектором того же размера. Второй вектор
+    // закрепляется снимком, чтобы повтор свертки читал те же его данные.
+    double dotParallel(const Vector& other, size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        other.checkInitialization();
+        if (other.n != n) {
+            throw std::invalid_argument("Размеры векторов не совпадают");
+        }
+        Snapshot second = other.snapshot();
+        const T* otherData = second.data();
+        return parallelReduce(
+            0.0,
+            [otherData](const T* chunk, size_t length, size_t offset) {
+                const T* second = otherData + offset;
+                double acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+                size_t i = 0;
+                for (; i + 4 <= length; i += 4) {
+                    acc0 += static_cast<double>(chunk[i]) * second[i];
+                    acc1 += static_cast<double>(chunk[i + 1]) * second[i + 1];
+                    acc2 += static_cast<double>(chunk[i + 2]) * second[i + 2];
+                    acc3 += static_cast<double>(chunk[i + 3]) * second[i + 3];
+                }
+                for (; i < length; ++i) {
+                    acc0 += static_cast<double>(chunk[i]) * second[i];
+                }
+                return (acc0 + acc1) + (acc2 + acc3);
+            },
+            std::plus<double>(),
+            {numThreads, schedule});
+    }
+
+    // Асинхронные варианты на общем исполнителе (см. executor.h). Вектор
+    // должен жить, пока не готов возвращенный future. Этап читает версию
+    // буфера, опубликованную к моменту его запуска, поэтому для наложения
+    // загрузки следующего набора на обработку текущего нужны два вектора.
+    // Результат ждут через Executor::await, если ожидающий сам выполняется
+    // на исполнителе.
+
+    // Произвольный этап fn(const Vector&)
+    template<typename F>
+    auto async(F&& fn) const {
+        return Executor::instance().submit([this, fn = std::forward<F>(fn)]() mutable {
+            return fn(*this);
+        });
+    }
+
+    std::future<void> importAsync(const std::string& filename) {
+        return Executor::instance().submit([this, filename] { Import(filename); });
+    }
+
+    std::future<void> importBinaryAsync(const std::string& filename, binary::ImportMode mode = binary::ImportMode::Copy) {
+        return Executor::instance().submit([this, filename, mode] { ImportBinary(filename, mode); });
+    }
+
+    std::future<void> exportAsync(const std::string& filename) const {
+        return Executor::instance().submit([this, filename] { Export(filename); });
+    }
+
+    std::future<void> exportBinaryAsync(const std::string& filename) const {
+        return Executor::instance().submit([this, filename] { ExportBinary(filename); });
+    }
+
+    std::future<std::tuple<T, size_t>> findMinAsync(size_t numThreads = ThreadPool::instance().size()) const {
+        return Executor::instance().submit([this, numThreads] { return findMinParallel(numThreads); });
+    }
+
+    std::future<std::tuple<T, size_t>> findMaxAsync(size_t numThreads = ThreadPool::instance().size()) const {
+        return Executor::instance().submit([this, numThreads] { return findMaxParallel(numThreads); });
+    }
+
+    std::future<Sum> calculateSumAsync(size_t numThreads = ThreadPool::instance().size()) const {
+        return Executor::instance().submit([this, numThreads] { return calculateSumParallel(numThreads); });
+    }
+
+    std::future<Statistics<T>> describeAsync(size_t numThreads = ThreadPool::instance().size()) const {
+        return Executor::instance().submit([this, numThreads] { return describeParallel(numThreads); });
+    }
+
+    // Порядковые статистики (см. orderStatistics.h). Полная сортировка нужна
+    // только sortParallel; остальные операции обходятся частичным отбором.
+
+    // k наибольших (Largest) или наименьших элементов с индексами: каждая
+    // часть держит кучу из k лучших, списки частей сливаются по порядку
+    template<bool Largest>
+    std::vector<std::pair<T, size_t>> selectTopK(size_t k, size_t numThreads, scheduler::Schedule schedule) const {
+        checkInitialization();
+        k = std::min(k, n);
+        if (k == 0) {
+            return {};
+        }
+        return parallelReduce(
+            std::vector<order::Ranked<T>>(),
+            [k](const T* chunk, size_t length, size_t offset) {
+                return order::topKRange<T, Largest>(chunk, length, offset, k);
+            },
+            [k](const std::vector<order::Ranked<T>>& a, const std::vector<order::Ranked<T>>& b) {
+                return order::mergeTopK<T, Largest>(a, b, k);
+            },
+            {numThreads, schedule});
+    }
+
+    // k наибольших элементов по убыванию, при равенстве - по возрастанию индекса
+    std::vector<std::pair<T, size_t>> topKParallel(size_t k, size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        return selectTopK<true>(k, numThreads, schedule);
+    }
+
+    // k наименьших элементов по возрастанию
+    std::vector<std::pair<T, size_t>> bottomKParallel(size_t k, size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        return selectTopK<false>(k, numThreads, schedule);
+    }
+
+    // Элементы с рангами first..last (включительно) в порядке возрастания.
+    // По случайной выборке выбираются границы, между которыми почти наверняка
+    // лежат нужные ранги; параллельный проход считает элементы ниже нижней
+    // границы и собирает элементы между границами, среди них ранги ищутся
+    // через nth_element. Если выборка ошиблась, запас расширяется, в худшем
+    // случае отбор выполняется по копии всего вектора.
+    std::vector<T> selectRanks(size_t first, size_t last, size_t numThreads) const {
+        return buffer.read([&](const Version& version) {
+            return selectRanks(version.data, first, last, numThreads);
+        });
+    }
+
+    static std::vector<T> ranksOf(std::vector<T>& values, size_t first, size_t last) {
+        std::nth_element(values.begin(), values.begin() + first, values.end());
+        std::partial_sort(values.begin() + first + 1, values.begin() + last + 1, values.end());
+        return std::vector<T>(values.begin() + first, values.begin() + last + 1);
+    }
+
+    // k-й по возрастанию элемент (k от нуля), вектор не меняется
+    T nthElementParallel(size_t k, size_t numThreads) const {
+        checkInitialization();
+        if (k >= n) {
+            throw std::out_of_range("Номер элемента больше размера вектора");
+        }
+        return selectRanks(k, k, numThreads)[0];
+    }
+
+    // Квантиль уровня q из [0, 1] с линейной интерполяцией между соседними
+    // элементами: 0.5 - медиана, 0.99 - p99
+    double quantileParallel(double q, size_t numThreads) const {
+        checkInitialization();
+        return buffer.read([&](const Version& version) {
+            return quantileOf(version.data, q, numThreads);
+        });
+    }
+
+    // Все квантили считаются по одной версии данных
+    std::vector<double> quantilesParallel(const std::vector<double>& levels, size_t numThreads) const {
+        return buffer.read([&](const Version& version) {
+            std::vector<double> result;
+            result.reserve(levels.size());
+            for (double q : levels) {
+                result.push_back(quantileOf(version.data, q, numThreads));
+            }
+            return result;
+        });
+    }
+
+    // Гистограмма из bins корзин равной ширины на [lo, hi]: каждая часть
+    // считает свои корзины, затем счетчики складываются
+    std::vector<size_t> histogramParallel(size_t bins, T lo, T hi, size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        if (bins == 0) {
+            throw std::invalid_argument("Число корзин должно быть положительным");
+        }
+        if (hi < lo) {
+            throw std::invalid_argument("Верхняя граница гистограммы меньше нижней");
+        }
+        return buffer.read([&](const Version& version) {
+            return histogramOf(version.data, bins, lo, hi, {numThreads, schedule});
+        });
+    }
+
+    // Гистограмма на отрезке от минимума до максимума вектора
+    std::vector<size_t> histogramParallel(size_t bins, size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkInitialization();
+        if (bins == 0) {
+            throw std::invalid_argument("Число корзин должно быть положительным");
+        }
+        return buffer.read([&](const Version& version) {
+            auto [lo, hi] = VectorView<T>(version.data, n).parallelReduce(
+                std::pair<T, T>(std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()),
+                [](const T* chunk, size_t length, size_t) {
+                    return std::pair<T, T>(simd::argMin(chunk, length).first, simd::argMax(chunk, length).first);
+                },
+                [](const std::pair<T, T>& a, const std::pair<T, T>& b) {
+                    return std::pair<T, T>(std::min(a.first, b.first), std::max(a.second, b.second));
+                },
+                {numThreads, schedule});
+            return histogramOf(version.data, bins, lo, hi, {numThreads, schedule});
+        });
+    }
+
+    // Сортировка по возрастанию (sample sort). Разделители корзин берутся из
+    // случайной выборки, каждая часть считает, сколько ее элементов попадает
+    // в каждую корзину, по этим счетчикам элементы раскладываются в новый
+    // буфер без блокировок, затем корзины сортируются в нем независимо и
+    // буфер публикуется.
+    void sortParallel(size_t numThreads) {
+        checkInitialization();
+        auto lock = buffer.lockWriters();
+        auto source = buffer.acquire();
+        const T* data = source->data;
+        auto version = buffer.create(n);
+        T* sorted = version->data;
+        if (numThreads <= 1 || n < parallelSortThreshold) {
+            std::copy(data, data + n, sorted);
+            std::sort(sorted, sorted + n);
+            buffer.publish(std::move(version));
+            return;
+        }
+
+        size_t numBuckets = numThreads;
+        std::vector<T> sample = order::sortedSample(data, n, numBuckets * sortOversampling, orderSampleSeed);
+        std::vector<T> splitters(numBuckets - 1);
+        for (size_t b = 1; b < numBuckets; ++b) {
+            splitters[b - 1] = sample[b * sample.size() / numBuckets];
+        }
+        auto bucketOf = [&](T value) {
+            return static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), value) - splitters.begin());
+        };
+
+        // counts[часть * numBuckets + корзина]; строка части заполняется целиком в конце
+        auto bounds = scheduler::partition(0, n, numThreads, scheduler::Schedule::Static);
+        size_t numChunks = bounds.size() - 1;
+        std::vector<size_t> counts(numChunks * numBuckets, 0);
+        runPartition(bounds, numThreads, scheduler::Schedule::Static, [&](size_t chunk, size_t start, size_t end) {
+            std::vector<size_t> local(numBuckets, 0);
+            for (size_t i = start; i < end; ++i) {
+                local[bucketOf(data[i])]++;
+            }
+            std::copy(local.begin(), local.end(), counts.begin() + chunk * numBuckets);
+        });
+
+        // Начало каждой корзины и место каждой части внутри нее
+        std::vector<size_t> bucketStart(numBuckets + 1, 0);
+        std::vector<size_t> offsets(numChunks * numBuckets);
+        for (size_t b = 0; b < numBuckets; ++b) {
+            size_t position = bucketStart[b];
+            for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+                offsets[chunk * numBuckets + b] = position;
+                position += counts[chunk * numBuckets + b];
+            }
+            bucketStart[b + 1] = position;
+        }
+
+        runPartition(bounds, numThreads, scheduler::Schedule::Static, [&](size_t chunk, size_t start, size_t end) {
+            std::vector<size_t> position(offsets.begin() + chunk * numBuckets, offsets.begin() + (chunk + 1) * numBuckets);
+            for (size_t i = start; i < end; ++i) {
+                sorted[position[bucketOf(data[i])]++] = data[i];
+            }
+        });
+
+        // Корзины разного размера, поэтому пул раздает их по одной
+        ThreadPool::instance().run(numBuckets, [&](size_t b) {
+            std::sort(sorted + bucketStart[b], sorted + bucketStart[b + 1]);
+        });
+        buffer.publish(std::move(version));
+    }
+
+private:
+    // Многопроходные запросы работают с одним буфером data, полученным
+    // через buffer.read, чтобы все проходы видели одну версию данных
+
+    std::vector<T> selectRanks(const T* data, size_t first, size_t last, size_t numThreads) const {
+        size_t sampleSize = std::min(n, selectionSampleSize);
+        std::vector<T> sample = order::sortedSample(data, n, sampleSize, orderSampleSeed);
+        size_t lowPosition = first * sampleSize / n;
+        size_t highPosition = last * sampleSize / n;
+
+        for (size_t margin = selectionMargin; margin < sampleSize; margin *= 4) {
+            // Запас за краем выборки: граница с этой стороны открыта, и
+            // корзина включает весь хвост (для p99, p1 и крайних рангов)
+            bool openBelow = lowPosition < margin;
+            bool openAbove = highPosition + margin >= sampleSize;
+            if (openBelow && openAbove) {
+                break;
+            }
+            T lower = openBelow ? std::numeric_limits<T>::lowest() : sample[lowPosition - margin];
+            T upper = openAbove ? std::numeric_limits<T>::max() : sample[highPosition + margin];
+            auto bucket = VectorView<T>(data, n).parallelReduce(
+                order::SelectionBucket<T>(),
+                [lower, upper](const T* chunk, size_t length, size_t) {
+                    return order::selectionRange(chunk, length, lower, upper);
+                },
+                [](order::SelectionBucket<T> a, const order::SelectionBucket<T>& b) {
+                    a.merge(b);
+                    return a;
+                },
+                {numThreads});
+            if (bucket.below <= first && last < bucket.below + bucket.candidates.size()) {
+                return ranksOf(bucket.candidates, first - bucket.below, last - bucket.below);
+            }
+        }
+
+        order::fullCopySelections().fetch_add(1, std::memory_order_relaxed);
+        std::vector<T> copy(data, data + n);
+        return ranksOf(copy, first, last);
+    }
+
+    double quantileOf(const T* data, double q, size_t numThreads) const {
+        auto [rank, fraction] = order::quantileRank(q, n);
+        if (fraction == 0.0 || rank + 1 >= n) {
+            return static_cast<double>(selectRanks(data, rank, rank, numThreads)[0]);
+        }
+        std::vector<T> values = selectRanks(data, rank, rank + 1, numThreads);
+        double low = static_cast<double>(values[0]);
+        return low + fraction * (static_cast<double>(values[1]) - low);
+    }
+
+    std::vector<size_t> histogramOf(const T* data, size_t bins, T lo, T hi, ReduceOptions options) const {
+        return VectorView<T>(data, n).parallelReduce(
+            std::vector<size_t>(bins, 0),
+            [bins, lo, hi](const T* chunk, size_t length, size_t) {
+                std::vector<size_t> counts(bins, 0);
+                order::histogramRange(chunk, length, lo, hi, counts);
+                return counts;
+            },
+            [](std::vector<size_t> a, const std::vector<size_t>& b) {
+                for (size_t i = 0; i < a.size(); ++i) {
+                    a[i] += b[i];
+                }
+                return a;
+            },
+            options);
+    }
+};
+
+// Вектор как операнд выражения: лист закрепляет снимок данных
+namespace expr {
+
+template<typename T, typename Allocator>
+struct OperandTraits<Vector<T, Allocator>> {
+    static constexpr bool isOperand = true;
+
+    static Terminal<T, typename Vector<T, Allocator>::Snapshot> wrap(const Vector<T, Allocator>& vec) {
+        auto snapshot = vec.snapshot();
+        const T* data = snapshot.data();
+        size_t size = snapshot.size();
+        return Terminal<T, typename Vector<T, Allocator>::Snapshot>(std::move(snapshot), data, size);
+    }
+};
+
+} // namespace expr
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binaryFormat.h"
+#include "paddedSlots.h"
+#include "statistics.h"
+#include "threadPool.h"
+
+// Потоковые редукции по двоичному файлу вектора (формат binaryFormat.h),
+// который не помещается в память. Файл читается блоками в два буфера:
+// фоновый поток читает следующий блок, пока пул потоков обрабатывает текущий,
+// поэтому вычисления перекрываются с чтением с диска. Вся память под данные -
+// два буфера, их общий размер не превышает memoryBudget байт.
+template<typename T>
+class VectorStream {
+private:
+    std::string filename;
+    size_t blockElements;
+    uint64_t count = 0;
+    uint64_t checksum = 0;
+    bool swapped = false;
+
+    // Буфер блока: данные, число элементов и номер первого элемента
+    struct Block {
+        std::vector<T> values;
+        size_t length = 0;
+        uint64_t offset = 0;
+        bool full = false;
+    };
+
+    class File {
+    public:
+        int fd;
+        explicit File(const std::string& name) : fd(open(name.c_str(), O_RDONLY)) {
+            if (fd < 0) {
+                throw std::ios_base::failure("Не удается открыть файл " + name);
+            }
+#ifdef POSIX_FADV_SEQUENTIAL
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        }
+        ~File() {
+            close(fd);
+        }
+        // Читает ровно length байт с позиции position
+        void readExact(void* into, size_t length, uint64_t position) const {
+            char* p = static_cast<char*>(into);
+            while (length > 0) {
+                ssize_t got = pread(fd, p, length, static_cast<off_t>(position));
+                if (got <= 0) {
+                    throw std::runtime_error("Ошибка чтения файла");
+                }
+                p += got;
+                length -= static_cast<size_t>(got);
+                position += static_cast<uint64_t>(got);
+            }
+        }
+    };
+
+public:
+    // Минимальный бюджет: два буфера хотя бы по 8 элементов
+    static constexpr size_t minBudget = 2 * 8 * sizeof(T);
+
+    VectorStream(const std::string& filename, size_t memoryBudget)
+        : filename(filename) {
+        static_assert(binary::typeTag<T>() != binary::Unknown, "Тип не поддерживается двоичным форматом");
+        if (memoryBudget < minBudget) {
+            throw std::invalid_argument("Слишком маленький бюджет памяти");
+        }
+        // Размер блока кратен 8 элементам, чтобы контрольная сумма по словам
+        // считалась блоками независимо
+        blockElements = memoryBudget / (2 * sizeof(T)) / 8 * 8;
+
+        File file(filename);
+        binary::BinaryHeader header;
+        file.readExact(&header, sizeof(header), 0);
+        struct stat info;
+        fstat(file.fd, &info);
+        swapped = binary::validateHeader<T>(header, static_cast<size_t>(info.st_size));
+        count = swapped ? binary::byteSwap(header.count) : header.count;
+        checksum = swapped ? binary::byteSwap(header.checksum) : header.checksum;
+        if (count == 0) {
+            throw std::runtime_error("Файл не содержит данных");
+        }
+    }
+
+    uint64_t size() const {
+        return count;
+    }
+
+    size_t blockSize() const {
+        return blockElements;
+    }
+
+    // Все характеристики за один проход по файлу; каждый блок делится на
+    // numThreads частей. Контрольная сумма проверяется по ходу чтения.
+    Statistics<T> describe(size_t numThreads) const {
+        if (numThreads == 0) {
+            throw std::invalid_argument("Число потоков должно быть положительным");
+        }
+        File file(filename);
+        Block blocks[2];
+        blocks[0].values.resize(blockElements);
+        blocks[1].values.resize(blockElements);
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool cancelled = false;
+        std::exception_ptr readError;
+        uint64_t readChecksum = 0;
+
+        // Фоновое чтение: заполняет буферы по очереди, пока файл не кончится
+        std::thread reader([&] {
+            try {
+                size_t slot = 0;
+                for (uint64_t offset = 0; offset < count; offset += blockElements) {
+                    Block& block = blocks[slot];
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        changed.wait(lock, [&] { return !block.full || cancelled; });
+                        if (cancelled) {
+                            return;
+                        }
+                    }
+                    size_t length = static_cast<size_t>(std::min<uint64_t>(blockElements, count - offset));
+                    file.readExact(block.values.data(), length * sizeof(T), sizeof(binary::BinaryHeader) + offset * sizeof(T));
+                    readChecksum += binary::checksum64(block.values.data(), length * sizeof(T), offset * sizeof(T) / 8);
+                    if (swapped) {
+                        for (size_t i = 0; i < length; ++i) {
+                            block.values[i] = binary::byteSwapValue(block.values[i]);
+                        }
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        block.length = length;
+                        block.offset = offset;
+                        block.full = true;
+                    }
+                    changed.notify_all();
+                    slot ^= 1;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                readError = std::current_exception();
+                changed.notify_all();
+            }
+        });
+
+        Statistics<T> stats;
+        PaddedSlots<Statistics<T>> partial(numThreads);
+        try {
+            size_t slot = 0;
+            for (uint64_t offset = 0; offset < count; offset += blockElements) {
+                Block& block = blocks[slot];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return block.full || readError; });
+                    if (readError) {
+                        std::rethrow_exception(readError);
+                    }
+                }
+
+                // Параллельная обработка блока теми же ядрами, что и у Vector
+                size_t chunkSize = block.length / numThreads;
+                ThreadPool::instance().run(numThreads, [&](size_t i) {
+                    size_t start = i * chunkSize;
+                    size_t end = (i == numThreads - 1) ? block.length : (i + 1) * chunkSize;
+                    partial[i] = describeRange(block.values.data() + start, end - start, block.offset + start);
+                });
+                partial.forEach([&](const Statistics<T>& part) {
+                    stats.merge(part);
+                });
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    block.full = false;
+                }
+                changed.notify_all();
+                slot ^= 1;
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancelled = true;
+            }
+            changed.notify_all();
+            reader.join();
+            throw;
+        }
+        reader.join();
+
+        if (readChecksum != checksum) {
+            throw std::runtime_error("Контрольная сумма не совпадает");
+        }
+        return stats;
+    }
+
+    std::pair<T, size_t> findMin(size_t numThreads) const {
+        Statistics<T> stats = describe(numThreads);
+        return {stats.min, stats.minIndex};
+    }
+
+    std::pair<T, size_t> findMax(size_t numThreads) const {
+        Statistics<T> stats = describe(numThreads);
+        return {stats.max, stats.maxIndex};
+    }
+
+    numeric::Accumulator<T> calculateSum(size_t numThreads) const {
+        return describe(numThreads).sum;
+    }
+
+    double calculateMean(size_t numThreads) const {
+        return describe(numThreads).mean;
+    }
+};
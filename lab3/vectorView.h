@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddedSlots.h"
+#include "scheduler.h"
+#include "simd.h"
+#include "statistics.h"
+#include "threadPool.h"
+
+// Параметры параллельных операций Vector и VectorView
+struct ReduceOptions {
+    size_t numThreads = ThreadPool::instance().size(); // число потоков (частей для Static)
+    scheduler::Schedule schedule = scheduler::Schedule::Static;
+    size_t grain = 0; // размер мелкой части для остальных расписаний, 0 - автоматически
+};
+
+// Невладеющее представление элементов data[0], data[stride], ...,
+// data[(size - 1) * stride] только для чтения. Создается без выделения
+// памяти и копирования (Vector::view/slice/strided), поэтому окна большого
+// буфера или части для разных потоков передаются по значению. Представление
+// действительно, пока жив и не перемещен вектор-владелец и не опубликован
+// его новый буфер (запись целиком); представление снимка
+// (Vector::snapshot) действительно, пока жив снимок.
+//
+// Все свертки работают с блоками подряд идущих значений: для непрерывного
+// представления блок - сама часть, а элементы с шагом больше единицы
+// сначала собираются в буфер по statisticsBlockSize элементов, чтобы по
+// нему прошли те же векторные ядра. Индексы в результатах считаются в
+// элементах представления.
+template<typename T>
+class VectorView {
+private:
+    const T* ptr;
+    size_t length;
+    size_t step;
+
+    // Вызывает fn(блок, длина, индекс начала) для элементов [from, to)
+    template<typename Fn>
+    void forEachBlock(size_t from, size_t to, Fn&& fn) const {
+        if (step == 1) {
+            fn(ptr + from, to - from, from);
+            return;
+        }
+        T buffer[statisticsBlockSize];
+        for (size_t start = from; start < to; start += statisticsBlockSize) {
+            size_t blockLen = std::min(statisticsBlockSize, to - start);
+            const T* source = ptr + start * step;
+            for (size_t i = 0; i < blockLen; ++i) {
+                buffer[i] = source[i * step];
+            }
+            fn(static_cast<const T*>(buffer), blockLen, start);
+        }
+    }
+
+    // Свертка элементов [from, to) по блокам в одном потоке
+    template<typename R, typename MapFn, typename CombineFn>
+    R reduceRange(size_t from, size_t to, R init, MapFn&& mapFn, CombineFn&& combineFn) const {
+        R result = init;
+        forEachBlock(from, to, [&](const T* block, size_t blockLen, size_t offset) {
+            result = combineFn(result, mapFn(block, blockLen, offset));
+        });
+        return result;
+    }
+
+    static std::pair<T, size_t> firstMin(const std::pair<T, size_t>& a, const std::pair<T, size_t>& b) {
+        return b.first < a.first ? b : a;
+    }
+
+    static std::pair<T, size_t> firstMax(const std::pair<T, size_t>& a, const std::pair<T, size_t>& b) {
+        return b.first > a.first ? b : a;
+    }
+
+    static std::pair<T, size_t> minOfBlock(const T* block, size_t blockLen, size_t offset) {
+        auto [value, index] = simd::argMin(block, blockLen);
+        return std::pair<T, size_t>(value, offset + index);
+    }
+
+    static std::pair<T, size_t> maxOfBlock(const T* block, size_t blockLen, size_t offset) {
+        auto [value, index] = simd::argMax(block, blockLen);
+        return std::pair<T, size_t>(value, offset + index);
+    }
+
+    static numeric::Accumulator<T> sumOfBlock(const T* block, size_t blockLen, size_t) {
+        return simd::sum(block, blockLen);
+    }
+
+    // Попарная (древовидная) сумма значений: форма дерева зависит только от
+    // их числа. Значения затираются промежуточными суммами.
+    template<typename S>
+    static S pairwiseSum(std::vector<S>& values) {
+        if (values.empty()) {
+            return S(0);
+        }
+        for (size_t width = 1; width < values.size(); width *= 2) {
+            for (size_t i = 0; i + width < values.size(); i += 2 * width) {
+                values[i] += values[i + width];
+            }
+        }
+        return values[0];
+    }
+
+    static Statistics<T> merged(Statistics<T> a, const Statistics<T>& b) {
+        a.merge(b);
+        return a;
+    }
+
+    void checkNotEmpty() const {
+        if (length == 0) {
+            throw std::logic_error("Представление пустое");
+        }
+    }
+
+public:
+    // Размер блока воспроизводимой суммы (calculateSumDeterministic)
+    static constexpr size_t deterministicBlockSize = statisticsBlockSize;
+
+    // Тип суммы элементов (numeric.h): целые - 64 бита, вещественные - double
+    using Sum = numeric::Accumulator<T>;
+
+    VectorView(const T* data, size_t size, size_t stride = 1) : ptr(data), length(size), step(stride) {
+        if (stride == 0) {
+            throw std::invalid_argument("Шаг представления должен быть положительным");
+        }
+    }
+
+    size_t size() const { return length; }
+    size_t stride() const { return step; }
+    const T* data() const { return ptr; }
+    bool isContiguous() const { return step == 1; }
+
+    const T& operator[](size_t i) const { return ptr[i * step]; }
+
+    // Элементы [lo, hi) этого представления
+    VectorView slice(size_t lo, size_t hi) const {
+        if (lo > hi || hi > length) {
+            throw std::out_of_range("Неверный диапазон [" + std::to_string(lo) + ", " + std::to_string(hi) + ")");
+        }
+        return VectorView(ptr + lo * step, hi - lo, step);
+    }
+
+    // Каждый every-й элемент, начиная с первого
+    VectorView strided(size_t every) const {
+        if (every == 0) {
+            throw std::invalid_argument("Шаг представления должен быть положительным");
+        }
+        return VectorView(ptr, (length + every - 1) / every, step * every);
+    }
+
+    // Обобщенная параллельная свертка, как Vector::parallelReduce:
+    // mapFn(блок, длина, индекс начала) -> R, результаты сворачиваются
+    // combineFn по порядку частей, начиная с нейтрального init
+    template<typename R, typename MapFn, typename CombineFn>
+    R parallelReduce(R init, MapFn&& mapFn, CombineFn&& combineFn, ReduceOptions options = {}) const {
+        if (length == 0) {
+            return init;
+        }
+        auto bounds = scheduler::partition(0, length, options.numThreads, options.schedule, options.grain);
+        PaddedSlots<R> partial(bounds.size() - 1, init);
+        scheduler::run(bounds.size() - 1, options.numThreads, options.schedule, [&](size_t chunk) {
+            if (bounds[chunk] < bounds[chunk + 1]) {
+                partial[chunk] = reduceRange(bounds[chunk], bounds[chunk + 1], init, mapFn, combineFn);
+            }
+        });
+
+        R result = init;
+        partial.forEach([&](const R& part) {
+            result = combineFn(result, part);
+        });
+        return result;
+    }
+
+    // Свертки экстремумов начинаются с элемента 0, а не с numeric_limits:
+    // результат - всегда элемент представления, даже если все элементы равны
+    // +inf (минимум) или -inf (максимум)
+    std::pair<T, size_t> findMin() const {
+        checkNotEmpty();
+        return reduceRange(0, length, std::pair<T, size_t>((*this)[0], 0), minOfBlock, firstMin);
+    }
+
+    std::pair<T, size_t> findMax() const {
+        checkNotEmpty();
+        return reduceRange(0, length, std::pair<T, size_t>((*this)[0], 0), maxOfBlock, firstMax);
+    }
+
+    Sum calculateSum() const {
+        return reduceRange(0, length, Sum(0), sumOfBlock, std::plus<Sum>());
+    }
+
+    double calculateMean() const {
+        checkNotEmpty();
+        return static_cast<double>(calculateSum()) / static_cast<double>(length);
+    }
+
+    Statistics<T> describe() const {
+        return reduceRange(0, length, Statistics<T>(), describeRange<T>, merged);
+    }
+
+    std::pair<T, size_t> findMinParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkNotEmpty();
+        return parallelReduce(std::pair<T, size_t>((*this)[0], 0), minOfBlock, firstMin, {numThreads, schedule});
+    }
+
+    std::pair<T, size_t> findMaxParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkNotEmpty();
+        return parallelReduce(std::pair<T, size_t>((*this)[0], 0), maxOfBlock, firstMax, {numThreads, schedule});
+    }
+
+    Sum calculateSumParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        return parallelReduce(Sum(0), sumOfBlock, std::plus<Sum>(), {numThreads, schedule});
+    }
+
+    double calculateMeanParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        checkNotEmpty();
+        return static_cast<double>(calculateSumParallel(numThreads, schedule)) / static_cast<double>(length);
+    }
+
+    // Воспроизводимая сумма: результат побитово одинаков при любом числе
+    // потоков и расписании. Элементы делятся на блоки по
+    // deterministicBlockSize с границами, кратными размеру блока, каждый блок
+    // суммируется векторным ядром, а суммы блоков складываются попарным
+    // деревом фиксированной формы. Потоки только распределяют блоки между
+    // собой. Результат может отличаться от calculateSum() и между машинами с
+    // разными наборами инструкций (ядра группируют слагаемые по-разному).
+    Sum calculateSumDeterministic(size_t numThreads = ThreadPool::instance().size(),
+                                  scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        // Проверка до деления на numThreads при выборе части; partition
+        // проверяет то же самое, но позже
+        if (numThreads == 0) {
+            throw std::invalid_argument("Число потоков должно быть положительным");
+        }
+        size_t blocks = (length + deterministicBlockSize - 1) / deterministicBlockSize;
+        std::vector<Sum> blockSums(blocks, Sum(0));
+        // Диапазон - номера блоков, а не элементов, поэтому и часть задается в
+        // блоках: с зернистостью по умолчанию (в элементах) вектор короче
+        // defaultMinGrain блоков оказался бы одной задачей
+        size_t grain = std::max<size_t>(1, blocks / (numThreads * scheduler::tasksPerThread));
+        auto bounds = scheduler::partition(0, blocks, numThreads, schedule, grain);
+        scheduler::run(bounds.size() - 1, numThreads, schedule, [&](size_t chunk) {
+            for (size_t b = bounds[chunk]; b < bounds[chunk + 1]; ++b) {
+                size_t from = b * deterministicBlockSize;
+                size_t to = std::min(length, from + deterministicBlockSize);
+                forEachBlock(from, to, [&](const T* block, size_t blockLen, size_t) {
+                    blockSums[b] = simd::sum(block, blockLen);
+                });
+            }
+        });
+        return pairwiseSum(blockSums);
+    }
+
+    Statistics<T> describeParallel(size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        return parallelReduce(Statistics<T>(), describeRange<T>, merged, {numThreads, schedule});
+    }
+
+    // Скалярное произведение с представлением той же длины
+    double dotParallel(const VectorView& other, size_t numThreads, scheduler::Schedule schedule = scheduler::Schedule::Static) const {
+        if (other.length != length) {
+            throw std::invalid_argument("Размеры векторов не совпадают");
+        }
+        return parallelReduce(
+            0.0,
+            [&other](const T* block, size_t blockLen, size_t offset) {
+                double acc0 = 0, acc1 = 0;
+                size_t i = 0;
+                for (; i + 2 <= blockLen; i += 2) {
+                    acc0 += static_cast<double>(block[i]) * other[offset + i];
+                    acc1 += static_cast<double>(block[i + 1]) * other[offset + i + 1];
+                }
+                for (; i < blockLen; ++i) {
+                    acc0 += static_cast<double>(block[i]) * other[offset + i];
+                }
+                return acc0 + acc1;
+            },
+            std::plus<double>(),
+            {numThreads, schedule});
+    }
+};
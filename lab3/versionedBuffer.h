@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "vectorView.h"
+
+// Буфер данных Vector с версиями. Читатели не берут блокировок, писатели
+// не ждут читателей.
+//
+// Запись целиком (инициализация, импорт, преобразование, сортировка)
+// заполняет новую версию и публикует ее атомарной заменой указателя (RCU):
+// читатель, успевший взять старую версию, дочитывает ее, а память старой
+// версии освобождается вместе с последней ссылкой на нее.
+//
+// Правка части элементов (set/setRange/transformRange) выполняется на месте
+// под счетчиком последовательности (seqlock): на время правки он нечетный.
+// Свертка запоминает счетчик, считает и повторяет расчет, если счетчик
+// изменился; после нескольких неудач она закрепляет версию (pin). Для
+// закрепленной версии правка не трогает данные, а публикует исправленную
+// копию, поэтому снимок (Snapshot) не меняется, пока существует.
+template<typename T, typename Allocator>
+class VersionedBuffer {
+public:
+    // Одна версия данных. data указывает в память Allocator или в память
+    // владельца owner: отображенный файл (ImportBinary в режиме Adopt) или
+    // сегмент разделяемой памяти (ImportShared).
+    struct Version {
+        T* data = nullptr;
+        size_t n = 0;
+        uint64_t id = 0;                         // номер версии, растет с каждой публикацией
+        std::shared_ptr<const void> owner;
+        bool readOnly = false;                   // правки всегда идут в копию
+        mutable std::atomic<size_t> pins{0};     // число снимков этой версии
+
+        ~Version() {
+            if (!owner) {
+                Allocator::template deallocate<T>(data, n);
+            }
+        }
+    };
+
+    // Закрепленная версия: данные не меняются, пока снимок существует
+    class Snapshot {
+    private:
+        std::shared_ptr<const Version> version;
+
+    public:
+        Snapshot() = default;
+        explicit Snapshot(std::shared_ptr<const Version> pinned) : version(std::move(pinned)) {}
+
+        Snapshot(const Snapshot& other) : version(other.version) {
+            if (version) {
+                version->pins.fetch_add(1);
+            }
+        }
+
+        Snapshot(Snapshot&& other) noexcept = default;
+
+        Snapshot& operator=(Snapshot other) noexcept {
+            std::swap(version, other.version);
+            return *this;
+        }
+
+        ~Snapshot() {
+            if (version) {
+                version->pins.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        explicit operator bool() const { return version != nullptr; }
+        const Version& get() const { return *version; }
+        const T* data() const { return version->data; }
+        size_t size() const { return version->n; }
+        uint64_t id() const { return version->id; }
+        VectorView<T> view() const { return VectorView<T>(data(), size()); }
+    };
+
+private:
+    std::shared_ptr<Version> current;     // читается и заменяется через atomic_load/atomic_store
+    std::atomic<uint64_t> sequence{0};    // нечетный, пока идет правка на месте
+    std::mutex writeLock;                 // писатели выполняются по одному
+    uint64_t nextId = 1;
+
+    // Сколько раз свертка пересчитывается без закрепления версии
+    static constexpr size_t optimisticReads = 3;
+
+    static void checkExists(const std::shared_ptr<const Version>& version) {
+        if (!version) {
+            throw std::logic_error("Вектор не инициализирован");
+        }
+    }
+
+public:
+    VersionedBuffer() = default;
+    VersionedBuffer(const VersionedBuffer&) = delete;
+    VersionedBuffer& operator=(const VersionedBuffer&) = delete;
+
+    // Текущая версия без закрепления (nullptr, если данных еще нет)
+    std::shared_ptr<const Version> acquire() const {
+        return std::atomic_load(&current);
+    }
+
+    // Закрепляет текущую версию. Закрепление и правка упорядочены через
+    // sequence: если правка началась раньше проверки, снимок берется заново,
+    // иначе правка увидит pins > 0 и сделает копию.
+    Snapshot pin() const {
+        for (;;) {
+            uint64_t before = sequence.load();
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::shared_ptr<const Version> version = acquire();
+            if (!version) {
+                return Snapshot();
+            }
+            version->pins.fetch_add(1);
+            if (sequence.load() == before) {
+                return Snapshot(std::move(version));
+            }
+            version->pins.fetch_sub(1);
+        }
+    }
+
+    // Свертка fn(const Version&) -> R без блокировок. fn может быть вызвана
+    // повторно, поэтому не должна иметь побочных эффектов.
+    template<typename F>
+    auto read(F&& fn) const {
+        for (size_t attempt = 0; attempt < optimisticReads; ++attempt) {
+            uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::shared_ptr<const Version> version = acquire();
+            checkExists(version);
+            auto result = fn(*version);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                return result;
+            }
+        }
+        Snapshot snapshot = pin();
+        if (!snapshot) {
+            throw std::logic_error("Вектор не инициализирован");
+        }
+        return fn(snapshot.get());
+    }
+
+    // Снимок для операций с побочными эффектами (экспорт, обход)
+    Snapshot pinInitialized() const {
+        Snapshot snapshot = pin();
+        if (!snapshot) {
+            throw std::logic_error("Вектор не инициализирован");
+        }
+        return snapshot;
+    }
+
+    // Остальные функции вызываются только под lockWriters()
+    std::unique_lock<std::mutex> lockWriters() {
+        return std::unique_lock<std::mutex>(writeLock);
+    }
+
+    // Новая версия из n элементов; память не инициализирована
+    std::shared_ptr<Version> create(size_t n) {
+        auto version = std::make_shared<Version>();
+        version->data = Allocator::template allocate<T>(n);
+        version->n = n;
+        version->id = nextId++;
+        return version;
+    }
+
+    // Новая версия поверх чужой памяти data, которую держит owner
+    std::shared_ptr<Version> adopt(std::shared_ptr<const void> owner, T* data, size_t n, bool readOnly) {
+        auto version = std::make_shared<Version>();
+        version->owner = std::move(owner);
+        version->data = data;
+        version->n = n;
+        version->readOnly = readOnly;
+        version->id = nextId++;
+        return version;
+    }
+
+    void publish(std::shared_ptr<Version> version) {
+        std::atomic_store(&current, std::move(version));
+    }
+
+    // Правка текущей версии fn(Version&): на месте, если версия не закреплена
+    // и доступна для записи, иначе в копии, которая затем публикуется
+    template<typename F>
+    void edit(F&& fn) {
+        struct Guard {
+            std::atomic<uint64_t>& sequence;
+            ~Guard() { sequence.fetch_add(1); }
+        };
+        sequence.fetch_add(1);
+        Guard guard{sequence};
+
+        std::shared_ptr<Version> version = current;
+        checkExists(version);
+        if (version->pins.load() == 0 && !version->readOnly) {
+            fn(*version);
+            return;
+        }
+        std::shared_ptr<Version> copy = create(version->n);
+        std::copy(version->data, version->data + version->n, copy->data);
+        fn(*copy);
+        publish(std::move(copy));
+    }
+
+    // Перемещение данных из other (используется перемещением Vector)
+    void takeFrom(VersionedBuffer& other) {
+        std::scoped_lock lock(writeLock, other.writeLock);
+        std::atomic_store(&current, std::atomic_exchange(&other.current, std::shared_ptr<Version>()));
+        nextId = std::max(nextId, other.nextId);
+    }
+};